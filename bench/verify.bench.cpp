@@ -0,0 +1,614 @@
+//////
+/// \file     verify.bench.cpp
+/// \brief    Measure the run-time cost of verify() on its pass and fail paths.
+///
+/// \details  Self-contained micro-benchmark, i.e. without any external (fetched) dependency.
+///
+///           Every case runs a batch of iterations per sample and reports the per-iteration time in ns
+///           as minimum, median and 99th percentile over all samples.
+///           The process is pinned to a single CPU (where the platform allows) to reduce noise.
+///
+///           The results are written as JSON (one benchmark per line, to keep it diff- and grep-friendly).
+///           Given a baseline (an earlier JSON output), every median is compared against it,
+///           and the exit code is non-zero if any case regressed beyond the tolerance.
+///
+///           Usage: verify-bench [--output <file.json>] [--baseline <file.json>] [--tolerance <ratio>] [--cpu <index>] [--filter <substring>]
+//////
+
+#include <verify.hpp> // DUT
+#include <verify-all.hpp> // DUT
+#include <verify-invariants.hpp> // DUT
+#include <verify-bytes.hpp> // DUT
+#include <verify-allclose.hpp> // DUT
+#include <verify-views.hpp> // DUT
+#include <verify-failure.hpp> // DUT
+#include <verify-content.hpp> // DUT
+#include <verify-records.hpp> // DUT
+
+// verify_lanes() works on GNU vectors, which only GCC and Clang have.
+#if defined(__GNUC__) || defined(__clang__)
+    #include <verify-lanes.hpp> // DUT
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+    #include <sched.h>
+#endif
+
+
+namespace {
+
+    //////
+    // == Harness ==
+
+    /// Keep the compiler from optimizing away `value` (or anything that leads to it).
+    template<typename T> inline void keep(const T & value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void * sink;
+        sink = &value;
+#endif
+    }
+
+    /// Make the compiler forget what it knows about `value`, so it can't constant-fold across iterations.
+    template<typename T> inline void launder(T & value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : "+m"(value) : : "memory");
+#else
+        keep(value);
+#endif
+    }
+
+    bool pin_to_cpu(int cpu)
+    {
+#if defined(__linux__)
+        if(cpu < 0)
+            cpu = sched_getcpu();
+        if(cpu < 0)
+            return false;
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return (0 == sched_setaffinity(0, sizeof(set), &set));
+#else
+        static_cast<void>(cpu);
+        return false;
+#endif
+    }
+
+    struct Result
+    {
+        std::string name;
+        double min_ns;
+        double median_ns;
+        double p99_ns;
+    };
+
+    constexpr std::size_t samples = 201;
+    constexpr auto sample_duration = std::chrono::microseconds(200);
+
+    /// Run `batch` repeatedly; the batch size is calibrated to roughly `sample_duration` per sample.
+    Result measure(const std::string & name, const std::function<void(std::size_t)> & batch)
+    {
+        using clock = std::chrono::steady_clock;
+
+        std::size_t iterations = 1;
+        for(;;)
+        {
+            const auto start = clock::now();
+            batch(iterations);
+            if(clock::now() - start >= sample_duration || iterations >= (std::size_t(1) << 30))
+                break;
+            iterations *= 2;
+        }
+
+        std::vector<double> ns(samples);
+        for(auto & sample : ns)
+        {
+            const auto start = clock::now();
+            batch(iterations);
+            const auto stop = clock::now();
+            sample = std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(iterations);
+        }
+
+        std::sort(ns.begin(), ns.end());
+        return Result{name, ns.front(), ns[ns.size() / 2], ns[(ns.size() * 99) / 100]};
+    }
+
+    /// A `std::streambuf` that discards everything, to measure the formatting without the sink.
+    struct NullBuffer : std::streambuf
+    {
+        int overflow(int c) override { return c; }
+        std::streamsize xsputn(const char *, std::streamsize n) override { return n; }
+    };
+
+    /// A `std::streambuf` writing into a fixed-size array, without any allocation.
+    template<std::size_t N> struct FixedBuffer : std::streambuf
+    {
+        char data[N];
+
+        FixedBuffer() { reset(); }
+        void reset() { setp(data, data + N); }
+    };
+
+
+    //////
+    // == Operand Types ==
+
+    struct Money
+    {
+        long long cents;
+
+        friend bool operator< (const Money & a, const Money & b) { return a.cents <  b.cents; }
+        friend std::ostream & operator<<(std::ostream & os, const Money & m) { return os << (m.cents / 100) << '.' << (m.cents % 100) << " EUR"; }
+    };
+
+    template<typename T> struct Operands;
+    template<> struct Operands<int>         { static int         a() { return 23; }     static int         b() { return 42; }     static constexpr const char * name = "int"; };
+    template<> struct Operands<double>      { static double      a() { return 2.3; }    static double      b() { return 4.2; }    static constexpr const char * name = "double"; };
+    template<> struct Operands<std::string> { static std::string a() { return "abc"; }  static std::string b() { return "abd"; }  static constexpr const char * name = "string"; };
+    template<> struct Operands<Money>       { static Money       a() { return {2300}; } static Money       b() { return {4200}; } static constexpr const char * name = "user"; };
+
+
+    /// Return the result through a call boundary, i.e. without inlining the decomposition into the caller.
+    template<typename T>
+#if defined(__GNUC__) || defined(__clang__)
+    __attribute__((noinline))
+#endif
+    auto returned(const T & a, const T & b)
+    {
+        return verify(a < b);
+    }
+
+
+    //////
+    // == Cases ==
+
+    template<typename T> void add_cases(std::vector<std::pair<std::string, std::function<void(std::size_t)>>> & cases)
+    {
+        const std::string type = Operands<T>::name;
+
+        cases.emplace_back("native/" + type, [](std::size_t n) {
+            T a = Operands<T>::a(), b = Operands<T>::b();
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(a);
+                keep(a < b);
+            }
+        });
+
+        cases.emplace_back("pass/" + type, [](std::size_t n) {
+            T a = Operands<T>::a(), b = Operands<T>::b();
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(a);
+                keep(static_cast<bool>(verify(a < b)));
+            }
+        });
+
+        cases.emplace_back("negation/" + type, [](std::size_t n) {
+            T a = Operands<T>::a(), b = Operands<T>::b();
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(a);
+                keep(static_cast<bool>(!verify(b < a)));
+            }
+        });
+
+        cases.emplace_back("auto/" + type, [](std::size_t n) {
+            T a = Operands<T>::a(), b = Operands<T>::b();
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(a);
+                auto pass = verify(a < b);
+                keep(pass);
+            }
+        });
+
+        cases.emplace_back("native-and/" + type, [](std::size_t n) {
+            T a = Operands<T>::a(), b = Operands<T>::b();
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(a);
+                keep(a < b && !(b < a));
+            }
+        });
+
+        cases.emplace_back("junction/" + type, [](std::size_t n) {
+            T a = Operands<T>::a(), b = Operands<T>::b();
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(a);
+                keep(static_cast<bool>(verify(a < b) && verify_lazily(!(b < a))));
+            }
+        });
+
+        cases.emplace_back("return/" + type, [](std::size_t n) {
+            T a = Operands<T>::a(), b = Operands<T>::b();
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(a);
+                keep(static_cast<bool>(returned(a, b)));
+            }
+        });
+
+        cases.emplace_back("ostream/" + type, [](std::size_t n) {
+            T a = Operands<T>::a(), b = Operands<T>::b();
+            NullBuffer buffer;
+            std::ostream os(&buffer);
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(a);
+                os << !verify(b < a);
+            }
+        });
+
+        cases.emplace_back("to_string/" + type, [](std::size_t n) {
+            T a = Operands<T>::a(), b = Operands<T>::b();
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(a);
+                std::ostringstream os;
+                os << !verify(b < a);
+                keep(os.str());
+            }
+        });
+
+        cases.emplace_back("failure/" + type, [](std::size_t n) {
+            T a = Operands<T>::a(), b = Operands<T>::b();
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(a);
+                const CppVerify::Failure failure(!verify(b < a), __FILE__, __LINE__);
+                keep(failure);
+            }
+        });
+
+        cases.emplace_back("fixed-buffer/" + type, [](std::size_t n) {
+            T a = Operands<T>::a(), b = Operands<T>::b();
+            FixedBuffer<256> buffer;
+            std::ostream os(&buffer);
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(a);
+                buffer.reset();
+                os << !verify(b < a);
+                keep(buffer.data);
+            }
+        });
+    }
+
+
+    /// A whole array: element by element, versus all at once.
+    void add_array_cases(std::vector<std::pair<std::string, std::function<void(std::size_t)>>> & cases)
+    {
+        static std::vector<float> prices(std::size_t(1) << 16, 1.0f);
+
+        cases.emplace_back("native-loop/float[64K]", [](std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(prices[0]);
+                bool pass = true;
+                for(const float x : prices)
+                    pass = pass && (x >= 0.0f);
+                keep(pass);
+            }
+        });
+
+        cases.emplace_back("verify-loop/float[64K]", [](std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(prices[0]);
+                bool pass = true;
+                for(const float x : prices)
+                    pass = pass && static_cast<bool>(verify(x >= 0.0f));
+                keep(pass);
+            }
+        });
+
+        cases.emplace_back("verify_all/float[64K]", [](std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(prices[0]);
+                keep(static_cast<bool>(verify_all(prices, >=, 0.0f)));
+            }
+        });
+
+        cases.emplace_back("std-is-sorted/float[64K]", [](std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(prices[0]);
+                keep(std::is_sorted(prices.begin(), prices.end()));
+            }
+        });
+
+        cases.emplace_back("verify_sorted/float[64K]", [](std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(prices[0]);
+                keep(static_cast<bool>(verify_sorted(prices)));
+            }
+        });
+
+        static std::vector<unsigned char> sent(std::size_t(1) << 16, 0x5A);
+        static std::vector<unsigned char> received(sent);
+
+        cases.emplace_back("memcmp/bytes[64K]", [](std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(sent[0]);
+                keep(std::memcmp(sent.data(), received.data(), sent.size()) == 0);
+            }
+        });
+
+        cases.emplace_back("verify_bytes_equal/bytes[64K]", [](std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(sent[0]);
+                keep(static_cast<bool>(verify_bytes_equal(sent.data(), received.data(), sent.size())));
+            }
+        });
+
+        // Against a digest instead of the received bytes, i.e. hashing one buffer instead of reading two.
+        static const CppVerify::Digest digest = CppVerify::digest(received);
+
+        cases.emplace_back("verify_same_content/bytes[64K]", [](std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(sent[0]);
+                keep(static_cast<bool>(verify_same_content(sent, digest)));
+            }
+        });
+
+        // Records of 24 bytes in as many bytes, checked on the calling thread (i.e. the kernel, not the pool).
+        struct Order { std::int64_t id; double price; std::int32_t qty; std::int32_t limit; };
+        static std::vector<Order> orders(sent.size() / sizeof(Order), Order{1, 9.5, 10, 1000});
+
+        cases.emplace_back("verify_records/Order[2730]", [](std::size_t n) {
+            const unsigned threads = CppVerify::record_threads();
+            CppVerify::record_threads() = 1;
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(orders[0]);
+                keep(static_cast<bool>(verify_records(orders.data(), orders.size() * sizeof(Order), CppVerify::field(&Order::price, "price") > 0.0, CppVerify::field(&Order::qty, "qty") <= 1000)));
+            }
+            CppVerify::record_threads() = threads;
+        });
+
+        static std::vector<float> expected(prices.size(), 1.0f);
+
+        cases.emplace_back("verify-loop-close/float[64K]", [](std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(prices[0]);
+                bool pass = true;
+                for(std::size_t j = 0; j < prices.size(); ++j)
+                    pass = pass && static_cast<bool>(verify(prices[j] == CppVerify::within_abs(expected[j], 1e-8f + 1e-5f * std::abs(expected[j]))));
+                keep(pass);
+            }
+        });
+
+        cases.emplace_back("verify_allclose/float[64K]", [](std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(prices[0]);
+                keep(static_cast<bool>(verify_allclose(prices, expected)));
+            }
+        });
+
+        // A row-major image against its column-major copy, i.e. one of them walked across its rows.
+        static constexpr std::size_t side = 1024;
+        static std::vector<float> image(side * side, 1.0f);
+        static std::vector<float> transposed(image);
+
+        cases.emplace_back("verify-loop-transposed/float[1K*1K]", [](std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(image[0]);
+                bool pass = true;
+                for(std::size_t r = 0; r < side; ++r)
+                    for(std::size_t c = 0; c < side; ++c)
+                        pass = pass && static_cast<bool>(verify(image[r * side + c] == transposed[c * side + r]));
+                keep(pass);
+            }
+        });
+
+        cases.emplace_back("verify_equal-transposed/float[1K*1K]", [](std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(image[0]);
+                keep(static_cast<bool>(verify_equal(CppVerify::row_major(image.data(), side, side), CppVerify::column_major(transposed.data(), side, side))));
+            }
+        });
+
+        // Printing the diff of two bit arrays, which differ in their last bit only.
+        // (The comparison itself is left out: That's the bit-by-bit `operator==` of the standard library.)
+        static std::vector<bool> mask(std::size_t(1) << 20);
+        static std::vector<bool> other_mask = [] { auto other = mask; other.back() = true; return other; }();
+        static const auto masks_equal = verify(mask == other_mask);
+
+        cases.emplace_back("ostream-diff/vector<bool>[1M]", [](std::size_t n) {
+            NullBuffer buffer;
+            std::ostream os(&buffer);
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(mask);
+                os << masks_equal;
+            }
+        });
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__SSE2__)
+        // A check inside a vectorized loop: each vector stored and checked lane by lane, versus all lanes at once.
+        cases.emplace_back("verify-per-lane/float[64K]", [](std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(prices[0]);
+                bool pass = true;
+                for(std::size_t j = 0; j < prices.size(); j += 4)
+                {
+                    const __m128 v = _mm_loadu_ps(prices.data() + j);
+                    float lanes[4];
+                    _mm_storeu_ps(lanes, v);
+                    for(const float x : lanes)
+                        pass = pass && static_cast<bool>(verify(x >= 0.0f));
+                }
+                keep(pass);
+            }
+        });
+
+        cases.emplace_back("verify_lanes/float[64K]", [](std::size_t n) {
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                launder(prices[0]);
+                bool pass = true;
+                for(std::size_t j = 0; j < prices.size(); j += 4)
+                {
+                    const __m128 v = _mm_loadu_ps(prices.data() + j);
+                    pass = pass && static_cast<bool>(verify_lanes(v, >=, 0.0f));
+                }
+                keep(pass);
+            }
+        });
+#endif
+    }
+
+
+    //////
+    // == JSON in and out ==
+
+    void write_json(std::ostream & os, const std::vector<Result> & results)
+    {
+        char line[512];
+        os << "{\n  \"benchmarks\": [\n";
+        for(std::size_t i = 0; i < results.size(); ++i)
+        {
+            const auto & r = results[i];
+            std::snprintf(line, sizeof(line), "    {\"name\": \"%s\", \"min_ns\": %.3f, \"median_ns\": %.3f, \"p99_ns\": %.3f}%s\n",
+                          r.name.c_str(), r.min_ns, r.median_ns, r.p99_ns, (i + 1 < results.size()) ? "," : "");
+            os << line;
+        }
+        os << "  ]\n}\n";
+    }
+
+    /// Read the medians of a file written by `write_json()`. (This is no general JSON parser.)
+    std::map<std::string, double> read_medians(std::istream & is)
+    {
+        std::map<std::string, double> medians;
+        std::string line;
+        while(std::getline(is, line))
+        {
+            const auto name = line.find("\"name\": \"");
+            const auto median = line.find("\"median_ns\": ");
+            if(name == std::string::npos || median == std::string::npos)
+                continue;
+
+            const auto begin = name + std::strlen("\"name\": \"");
+            const auto end = line.find('"', begin);
+            medians[line.substr(begin, end - begin)] = std::strtod(line.c_str() + median + std::strlen("\"median_ns\": "), nullptr);
+        }
+        return medians;
+    }
+
+}
+
+
+int main(int argc, char ** argv)
+{
+    std::string output, baseline, filter;
+    double tolerance = 0.5;
+    int cpu = -1;
+
+    for(int i = 1; i < argc; ++i)
+    {
+        const std::string arg = argv[i];
+        const bool has_value = (i + 1 < argc);
+        if(arg == "--output" && has_value)
+            output = argv[++i];
+        else if(arg == "--baseline" && has_value)
+            baseline = argv[++i];
+        else if(arg == "--tolerance" && has_value)
+            tolerance = std::strtod(argv[++i], nullptr);
+        else if(arg == "--cpu" && has_value)
+            cpu = std::atoi(argv[++i]);
+        else if(arg == "--filter" && has_value)
+            filter = argv[++i];
+        else
+        {
+            std::cerr << "usage: " << argv[0] << " [--output <file.json>] [--baseline <file.json>] [--tolerance <ratio>] [--cpu <index>] [--filter <substring>]" << std::endl;
+            return 2;
+        }
+    }
+
+    if(!pin_to_cpu(cpu))
+        std::cerr << "warning: could not pin to a CPU, expect more noise" << std::endl;
+
+    std::vector<std::pair<std::string, std::function<void(std::size_t)>>> cases;
+    add_cases<int>(cases);
+    add_cases<double>(cases);
+    add_cases<std::string>(cases);
+    add_cases<Money>(cases);
+    add_array_cases(cases);
+
+    std::vector<Result> results;
+    for(const auto & c : cases)
+        if(c.first.find(filter) != std::string::npos)
+            results.push_back(measure(c.first, c.second));
+
+    if(output.empty())
+        write_json(std::cout, results);
+    else
+    {
+        std::ofstream file(output);
+        write_json(file, results);
+    }
+
+    if(baseline.empty())
+        return 0;
+
+    std::ifstream file(baseline);
+    if(!file)
+    {
+        std::cerr << "error: cannot read baseline " << baseline << std::endl;
+        return 2;
+    }
+
+    const auto medians = read_medians(file);
+    int regressions = 0;
+    for(const auto & r : results)
+    {
+        const auto found = medians.find(r.name);
+        if(found == medians.end())
+        {
+            std::cerr << r.name << ": not in baseline" << std::endl;
+            continue;
+        }
+
+        const double ratio = r.median_ns / found->second;
+        const bool regressed = (ratio > 1.0 + tolerance);
+        regressions += regressed;
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-28s %10.3f ns  (baseline %10.3f ns, x%.2f)%s", r.name.c_str(), r.median_ns, found->second, ratio, regressed ? "  REGRESSION" : "");
+        std::cerr << line << std::endl;
+    }
+
+    return (regressions > 0) ? 1 : 0;
+}
@@ -0,0 +1,158 @@
+//////
+/// \file     verify-all.hpp
+/// \brief    Provide the verify_all() function, that checks one comparison for every element of an array at once.
+///
+/// \details  Implemented as a function-style macro, with the comparison operator as its second argument:
+///           ```
+///           std::vector<double> prices = ...;
+///           std::cout << verify_all(prices, >=, 0.0);
+///           ```
+///           will print something like: "verify_all(prices >= 0.0) => verify_all(1000 of 1000 elements pass) => true",
+///           or, if anything fails: "verify_all(prices >= 0.0) => verify_all([17]: -3 >= 0; 5 of 1000 elements fail) => false".
+///
+///           The right-hand side is either a single value, or another array, which is then compared pairwise (e.g. `verify_all(a, ==, b)`).
+///           Arrays of different size fail; every unmatched element counts as one failure.
+///           Any contiguous range will do (i.e. anything with `std::data()` and `std::size()`), e.g. C arrays, `std::vector` and `std::array`.
+///
+///           Arrays of arithmetic types are checked by vectorized kernels (see verify-kernels.hpp).
+///           Those run at (nearly) memory bandwidth while all elements pass, and count the failures only after the first one.
+///           Other element types are compared one by one, via the same comparison tags as verify().
+///
+///           The return value is stored, negated and printed like that of verify(). It keeps copies of the first failing elements only.
+///           With `CPP_VERIFY_DECOMPOSE=0`, only the code is kept alongside the boolean result (and the failures aren't counted).
+//////
+
+#ifndef CPP_VERIFY_ALL_HPP
+#define CPP_VERIFY_ALL_HPP
+
+#include "verify.hpp"
+#include "verify-kernels.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <ostream>
+#include <type_traits>
+
+#define verify_all(range, comparison, operand) \
+    CPP_VERIFY__IGNORE_SUPERFLUOUS_WARNINGS( \
+        \
+        (CppVerify::each(#range " " #comparison " " #operand, (range)) comparison (operand)) \
+        \
+    )
+
+namespace CppVerify {
+
+template<typename Range> using element_t = ::std::remove_cv_t<::std::remove_reference_t<decltype(*::std::data(::std::declval<const Range &>()))>>;
+
+/// Whether the right-hand side `U` of verify_all() is a second array (rather than a single value) to compare against `Range`.
+template<typename Range, typename U, typename = void> struct is_other_array : ::std::false_type { };
+template<typename Range, typename U> struct is_other_array<Range, U, ::std::void_t<element_t<U>, decltype(::std::size(::std::declval<const U &>()))>>
+    : ::std::integral_constant<bool, !::std::is_convertible<const U &, element_t<Range>>::value> { };
+
+
+#if CPP_VERIFY_DECOMPOSE
+
+template<typename T, typename Comparison, typename U> struct AllExpression
+{
+    static constexpr const char * macro = "verify_all";
+
+    const ::std::size_t size;           ///< Amount of elements on the left-hand side.
+    const ::std::size_t other_size;     ///< Amount of elements on the right-hand side (same as `size` for a single value).
+    const ::std::size_t first;          ///< Index of the first failing element, or `size` if none failed.
+    const ::std::size_t failures;       ///< Amount of failing elements.
+    const ::std::optional<T> op1;       ///< The first failing element.
+    const ::std::optional<U> op2;       ///< What it was compared to.
+
+    constexpr bool evaluate() const { return (failures == 0); }
+
+    friend ::std::ostream & operator<<(::std::ostream & os, const AllExpression & this_)
+    {
+        const ::std::size_t total = (this_.size < this_.other_size) ? this_.other_size : this_.size;
+        if(this_.failures == 0)
+            return os << total << " of " << total << " elements pass";
+
+        if(this_.op1 && this_.op2)
+            os << '[' << this_.first << "]: " << *this_.op1 << Comparison() << *this_.op2 << "; ";
+        if(this_.size != this_.other_size)
+            os << "sizes differ: " << this_.size << " != " << this_.other_size << "; ";
+        return os << this_.failures << " of " << total << " elements fail";
+    }
+};
+
+#endif // CPP_VERIFY_DECOMPOSE
+
+
+/// Compare `n` elements of `a` to `b` (a `Kernels::Broadcast`, `Kernels::Array` or `Kernels::Reference`),
+/// where `other[i * stride]` is what `a[i]` is compared to (i.e. a stride of 0 for a single value).
+template<typename Comparison, typename T, typename Source, typename U>
+auto check_all(const char * code, const T * a, const ::std::size_t n, const Source & b, const U * other, const ::std::size_t other_size, const ::std::size_t stride)
+{
+    const ::std::size_t common = (n < other_size) ? n : other_size;
+#if CPP_VERIFY_DECOMPOSE
+    const auto scan = Kernels::scan<Comparison>(a, b, common);
+    const ::std::size_t unmatched = (n - common) + (other_size - common);
+    const bool found = (scan.failures > 0);
+    return make_decomposition(code, AllExpression<T, Comparison, ::std::decay_t<const U>>{
+        n, other_size, found ? scan.first : n, scan.failures + unmatched,
+        found ? ::std::optional<T>(a[scan.first]) : ::std::nullopt,
+        found ? ::std::optional<::std::decay_t<const U>>(other[scan.first * stride]) : ::std::nullopt
+    });
+#else
+    static_cast<void>(other);
+    static_cast<void>(stride);
+    return Condition(code, (n == other_size) && (Kernels::find_first<Comparison>(a, b, common) == common));
+#endif
+}
+
+
+/// Compare each element of an array to a value, or to the corresponding element of another array.
+template<typename Comparison, typename Range, typename U>
+auto compare_each(const char * code, const Range & range, const U & op2)
+{
+    using T = element_t<Range>;
+    const T * const a = ::std::data(range);
+    const ::std::size_t n = ::std::size(range);
+
+    if constexpr(is_other_array<Range, U>::value)
+    {
+        // Distinct element types are compared element by element (with the usual arithmetic conversions, if any).
+        const auto * const b = ::std::data(op2);
+        return check_all<Comparison>(code, a, n, Kernels::Array<element_t<U>>{b}, b, ::std::size(op2), 1);
+    }
+    else
+    {
+        // A single value is broadcast into the vectors, if that doesn't change the result of any comparison:
+        // Either the usual arithmetic conversions yield the element type anyway,
+        // or it is a floating-point value that the (floating-point) element type represents exactly.
+        if constexpr(Kernels::is_vectorizable<T>::value && Kernels::is_vectorizable<U>::value)
+        {
+            constexpr bool converts = ::std::is_same<::std::common_type_t<T, U>, T>::value;
+            constexpr bool floating = ::std::is_floating_point<T>::value && ::std::is_floating_point<U>::value;
+            if(converts || (floating && static_cast<U>(static_cast<T>(op2)) == op2))
+                return check_all<Comparison>(code, a, n, Kernels::Broadcast<T>{static_cast<T>(op2)}, &op2, n, 0);
+        }
+        return check_all<Comparison>(code, a, n, Kernels::Reference<U>{op2}, &op2, n, 0);
+    }
+}
+
+
+/// Capture the array and offer the comparison operators, that capture the right-hand side.
+template<typename Range> struct Each
+{
+    const char * const code;
+    const Range & range;
+
+    template<typename U> auto operator==(const U & op2) const { return compare_each<EQ>(code, range, op2); }
+    template<typename U> auto operator!=(const U & op2) const { return compare_each<NE>(code, range, op2); }
+    template<typename U> auto operator<=(const U & op2) const { return compare_each<LE>(code, range, op2); }
+    template<typename U> auto operator>=(const U & op2) const { return compare_each<GE>(code, range, op2); }
+    template<typename U> auto operator< (const U & op2) const { return compare_each<LT>(code, range, op2); }
+    template<typename U> auto operator> (const U & op2) const { return compare_each<GT>(code, range, op2); }
+};
+
+template<typename Range> constexpr Each<Range> each(const char * code, const Range & range) { return Each<Range>{code, range}; }
+
+}
+
+#endif
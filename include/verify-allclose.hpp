@@ -0,0 +1,117 @@
+//////
+/// \file     verify-allclose.hpp
+/// \brief    Provide the verify_allclose() function, that checks two floating-point arrays for equality within a tolerance.
+///
+/// \details  Like `numpy.allclose()`, `verify_allclose(a, b, rtol, atol)` holds if `|a[i] - b[i]| <= atol + rtol * |b[i]|` for all `i`:
+///           ```
+///           std::vector<float> output = ..., expected = ...;
+///           std::cout << verify_allclose(output, expected, 1e-5, 1e-8);
+///           ```
+///           will print something like:
+///           "verify_allclose(output, expected, 1e-5, 1e-8) => verify_allclose(worst [17]: 1.75 vs. 1.5; 2 of 1000 elements not close
+///           (rtol 1e-05, atol 1e-08; max absolute error 0.25, max relative error 0.166667)) => false".
+///           The worst element is the first failing one with the largest absolute error (NaN being the largest),
+///           or, if all elements are close, the one with the largest absolute error.
+///
+///           The tolerances default to those of NumPy, i.e. `rtol = 1e-5` and `atol = 1e-8`. NaN is never close; equal infinities are.
+///           Any contiguous ranges of `float` or `double` will do (e.g. `std::vector`, `std::array`, `std::span`), both of the same element type.
+///           Arrays of different size fail; every unmatched element counts as one failure.
+///
+///           The largest absolute and relative errors, the index of the worst element, and the amount of failures
+///           are gathered in a single vectorized pass (see verify-kernels.hpp), whether the arrays are close or not.
+///           Where the instruction set has FMA, the tolerance is rounded once, so that elements right at its boundary
+///           may be judged differently than by the scalar fallback.
+///
+///           With `CPP_VERIFY_DECOMPOSE=0`, only the code is kept alongside the boolean result.
+//////
+
+#ifndef CPP_VERIFY_ALLCLOSE_HPP
+#define CPP_VERIFY_ALLCLOSE_HPP
+
+#include "verify.hpp"
+#include "verify-all.hpp"
+#include "verify-kernels.hpp"
+
+#include <cstddef>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+
+#define verify_allclose(...) (CppVerify::check_allclose(#__VA_ARGS__, __VA_ARGS__))
+
+namespace CppVerify {
+
+#if CPP_VERIFY_DECOMPOSE
+
+template<typename T> struct AllCloseExpression
+{
+    static constexpr const char * macro = "verify_allclose";
+
+    const ::std::size_t size;               ///< Amount of elements on the left-hand side.
+    const ::std::size_t other_size;         ///< Amount of elements on the right-hand side.
+    const T rtol;
+    const T atol;
+    const Kernels::Closeness<T> closeness;  ///< Statistics over the elements common to both sides.
+    const T op1;                            ///< The worst element, if any.
+    const T op2;                            ///< What it was compared to.
+
+    constexpr bool evaluate() const { return (closeness.failures == 0 && size == other_size); }
+
+    friend ::std::ostream & operator<<(::std::ostream & os, const AllCloseExpression & this_)
+    {
+        const ::std::size_t total = (this_.size < this_.other_size) ? this_.other_size : this_.size;
+        const ::std::size_t common = (this_.size < this_.other_size) ? this_.size : this_.other_size;
+        const ::std::size_t failures = this_.closeness.failures + (total - common);
+
+        if(failures > 0 && this_.closeness.worst < common)
+        {
+            // Round-trip precision, so that distinct values are shown distinctly.
+            const auto precision = os.precision(::std::numeric_limits<T>::max_digits10);
+            os << "worst [" << this_.closeness.worst << "]: " << this_.op1 << " vs. " << this_.op2 << "; ";
+            os.precision(precision);
+        }
+        if(this_.size != this_.other_size)
+            os << "sizes differ: " << this_.size << " != " << this_.other_size << "; ";
+        if(failures == 0)
+            os << total << " of " << total << " elements close";
+        else
+            os << failures << " of " << total << " elements not close";
+        return os << " (rtol " << this_.rtol << ", atol " << this_.atol
+                  << "; max absolute error " << this_.closeness.max_absolute << ", max relative error " << this_.closeness.max_relative << ')';
+    }
+};
+
+#endif // CPP_VERIFY_DECOMPOSE
+
+
+/// Compare two contiguous ranges of floating-point numbers element-wise, within the tolerance `atol + rtol * |b[i]|`.
+template<typename Range, typename OtherRange>
+auto check_allclose(const char * code, const Range & range, const OtherRange & other, const double rtol = 1e-5, const double atol = 1e-8)
+{
+    using T = element_t<Range>;
+    static_assert(::std::is_same<T, float>::value || ::std::is_same<T, double>::value, "verify_allclose() compares arrays of float or double.");
+    static_assert(::std::is_same<T, element_t<OtherRange>>::value, "verify_allclose() compares arrays of the same element type.");
+
+    const T * const a = ::std::data(range);
+    const T * const b = ::std::data(other);
+    const ::std::size_t n = ::std::size(range);
+    const ::std::size_t other_size = ::std::size(other);
+    const ::std::size_t common = (n < other_size) ? n : other_size;
+    const auto closeness = Kernels::closeness(a, b, common, static_cast<T>(rtol), static_cast<T>(atol));
+
+#if CPP_VERIFY_DECOMPOSE
+    const bool found = (closeness.worst < common);
+    return make_decomposition(code, AllCloseExpression<T>{
+        n, other_size, static_cast<T>(rtol), static_cast<T>(atol), closeness,
+        found ? a[closeness.worst] : T(0), found ? b[closeness.worst] : T(0)
+    });
+#else
+    return Condition(code, closeness.failures == 0 && n == other_size);
+#endif
+}
+
+}
+
+#endif
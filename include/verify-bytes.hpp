@@ -0,0 +1,152 @@
+//////
+/// \file     verify-bytes.hpp
+/// \brief    Provide the verify_bytes_equal() function, that compares raw memory like `memcmp()`, but shows where and how it differs.
+///
+/// \details  `verify_bytes_equal(actual, expected, n)` compares `n` bytes at the two addresses:
+///           ```
+///           std::cout << verify_bytes_equal(sent.data(), received.data(), sent.size());
+///           ```
+///           will print something like:
+///           ```
+///           verify_bytes_equal(sent.data(), received.data(), sent.size()) => verify_bytes_equal(first difference at offset 6 of 12 bytes
+///             actual   @0: 48 65 6c 6c 6f 20 77 6f 72 6c 64 21  |Hello world!|
+///             expected @0: 48 65 6c 6c 6f 20 57 6f 72 6c 64 21  |Hello World!|
+///                                             ^^
+///           ) => false
+///           ```
+///           The window shows at most `CPP_VERIFY_BYTES_WINDOW` bytes (16 by default) around the first difference.
+///           Its bytes are copied into the result, so it stays printable after the buffers are gone.
+///
+///           Counting all differing bytes takes a second pass, which is only done on request:
+///           `verify_bytes_equal(actual, expected, n, CppVerify::count_mismatches)` additionally prints e.g. "(3 bytes differ)".
+///
+///           The first difference is found by the vectorized kernels of verify_all(), i.e. at about the speed of `memcmp()`.
+///           With `CPP_VERIFY_DECOMPOSE=0`, only the code is kept alongside the boolean result.
+//////
+
+#ifndef CPP_VERIFY_BYTES_HPP
+#define CPP_VERIFY_BYTES_HPP
+
+#include "verify.hpp"
+#include "verify-kernels.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <ios>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+#ifndef CPP_VERIFY_BYTES_WINDOW
+    #define CPP_VERIFY_BYTES_WINDOW 16
+#endif
+
+#define verify_bytes_equal(...) (CppVerify::compare_bytes(#__VA_ARGS__, __VA_ARGS__))
+
+namespace CppVerify {
+
+/// Tag to request the count of all differing bytes from verify_bytes_equal().
+struct CountMismatches { };
+constexpr CountMismatches count_mismatches{};
+
+
+#if CPP_VERIFY_DECOMPOSE
+
+struct BytesExpression
+{
+    static constexpr const char * macro = "verify_bytes_equal";
+    static constexpr ::std::size_t window = CPP_VERIFY_BYTES_WINDOW;
+
+    ::std::size_t size;         ///< Amount of compared bytes.
+    ::std::size_t first;        ///< Offset of the first difference, or `size` if there is none.
+    ::std::size_t mismatches;   ///< Amount of differing bytes, if counted (else 0).
+    ::std::size_t start;        ///< Offset of the window.
+    ::std::size_t length;       ///< Amount of bytes in the window.
+    unsigned char actual[window];
+    unsigned char expected[window];
+
+    constexpr bool evaluate() const { return (first == size); }
+
+    friend ::std::ostream & operator<<(::std::ostream & os, const BytesExpression & this_)
+    {
+        if(this_.evaluate())
+            return os << this_.size << " bytes equal";
+
+        os << "first difference at offset " << this_.first << " of " << this_.size << " bytes";
+        if(this_.mismatches > 0)
+            os << " (" << this_.mismatches << " bytes differ)";
+        os << '\n';
+
+        // The offset column has the same width in both lines, so that the bytes line up (and the caret below them).
+        ::std::ostringstream offset;
+        offset << '@' << this_.start << ": ";
+        const auto print = [&](const char * label, const unsigned char * bytes) {
+            os << "  " << label << offset.str() << ::std::hex << ::std::setfill('0');
+            for(::std::size_t i = 0; i < this_.length; ++i)
+                os << ::std::setw(2) << static_cast<unsigned>(bytes[i]) << ' ';
+            os << ::std::dec << ::std::setfill(' ') << " |";
+            for(::std::size_t i = 0; i < this_.length; ++i)
+                os << ((bytes[i] >= 0x20 && bytes[i] < 0x7F) ? static_cast<char>(bytes[i]) : '.');
+            os << "|\n";
+        };
+        print("actual   ", this_.actual);
+        print("expected ", this_.expected);
+
+        const ::std::size_t column = 2 + 9 + offset.str().size() + 3 * (this_.first - this_.start);
+        return os << ::std::string(column, ' ') << "^^\n";
+    }
+};
+
+/// Copy the window around the first difference (`x.first`) of the `x.size` bytes at `a` and `b`.
+inline void frame(BytesExpression & x, const unsigned char * a, const unsigned char * b)
+{
+    // Center the window on the first difference, as far as the buffers allow.
+    constexpr ::std::size_t window = BytesExpression::window;
+    const ::std::size_t n = x.size;
+    x.start = (x.first < window / 2) ? 0 : (x.first - window / 2);
+    const ::std::size_t last = (n > window) ? (n - window) : 0;
+    if(x.start > last)
+        x.start = last;
+    x.length = (n - x.start < window) ? (n - x.start) : window;
+    ::std::memcpy(x.actual, a + x.start, x.length);
+    ::std::memcpy(x.expected, b + x.start, x.length);
+}
+
+#endif // CPP_VERIFY_DECOMPOSE
+
+
+inline auto check_bytes(const char * code, const void * actual, const void * expected, const ::std::size_t n, const bool count)
+{
+    const auto * const a = static_cast<const unsigned char *>(actual);
+    const auto * const b = static_cast<const unsigned char *>(expected);
+    const ::std::size_t first = Kernels::find_mismatch(a, b, n);
+
+#if CPP_VERIFY_DECOMPOSE
+    BytesExpression x{n, first, 0, 0, 0, {}, {}};
+    if(first < n)
+    {
+        frame(x, a, b);
+        if(count)
+            x.mismatches = 1 + Kernels::count_mismatches(a, b, first + 1, n);
+    }
+    return make_decomposition(code, x);
+#else
+    static_cast<void>(count);
+    return Condition(code, first == n);
+#endif
+}
+
+inline auto compare_bytes(const char * code, const void * actual, const void * expected, const ::std::size_t n)
+{
+    return check_bytes(code, actual, expected, n, false);
+}
+
+inline auto compare_bytes(const char * code, const void * actual, const void * expected, const ::std::size_t n, CountMismatches)
+{
+    return check_bytes(code, actual, expected, n, true);
+}
+
+}
+
+#endif
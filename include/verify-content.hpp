@@ -0,0 +1,306 @@
+//////
+/// \file     verify-content.hpp
+/// \brief    Provide the verify_same_content() function, that checks (large) buffers against a digest of 128-bit chunk hashes.
+///
+/// \details  `CppVerify::digest(data, n)` hashes `n` bytes in chunks of `CPP_VERIFY_DIGEST_CHUNK` bytes (1 MiB by default).
+///           The digest is small (16 bytes per chunk), and can be written to a stream, and read back, e.g. by another process:
+///           ```
+///           std::ofstream("snapshot.digest") << CppVerify::digest(snapshot.data(), snapshot.size());
+///           ...
+///           CppVerify::Digest expected;
+///           std::ifstream("snapshot.digest") >> expected;
+///           std::cout << verify_same_content(snapshot.data(), snapshot.size(), expected);
+///           ```
+///           Thus, the reference data needn't be in memory (nor anywhere else). The buffer is hashed chunk by chunk,
+///           and the first chunk whose hash differs from the digest is reported:
+///           ```
+///           verify_same_content(snapshot.data(), snapshot.size(), expected) => verify_same_content(16777216 bytes, chunk 3 of 16 differs from the digest at bytes [3145728, 4194304)) => false
+///           ```
+///           Given a reference as well (e.g. `CppVerify::reference_file(path)`), just that chunk is read from it
+///           (and only on failure), to show the first difference like verify_bytes_equal() does:
+///           ```
+///           verify_same_content(snapshot.data(), snapshot.size(), expected, CppVerify::reference_file("snapshot.bin")) => verify_same_content(16777216 bytes, chunk 3 of 16 differs from the digest, first difference at offset 3145790 of 16777216 bytes
+///             actual   @3145782: ...
+///             expected @3145782: ...
+///                                                       ^^
+///           ) => false
+///           ```
+///           A reference is any callable `bool(std::size_t offset, unsigned char * bytes, std::size_t n)` that fills `bytes` with the `n`
+///           reference bytes at `offset`, or returns `false`.
+///
+///           The hash is computed by the vectorized kernels of verify_all(). Hashes of the same bytes are the same for all instruction sets,
+///           but depend on the byte order of the host. With `CPP_VERIFY_DECOMPOSE=0`, only the code is kept alongside the boolean result.
+//////
+
+#ifndef CPP_VERIFY_CONTENT_HPP
+#define CPP_VERIFY_CONTENT_HPP
+
+#include "verify.hpp"
+#include "verify-kernels.hpp"
+#include "verify-bytes.hpp"
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <istream>
+#include <iterator>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifndef CPP_VERIFY_DIGEST_CHUNK
+    #define CPP_VERIFY_DIGEST_CHUNK (::std::size_t(1) << 20)
+#endif
+
+#define verify_same_content(...) (CppVerify::check_content(#__VA_ARGS__, __VA_ARGS__))
+
+namespace CppVerify {
+
+/// The hashes of the chunks of a buffer, and its size.
+class Digest
+{
+public:
+    Digest() = default;
+
+    Digest(const ::std::size_t size, const ::std::size_t chunk, ::std::vector<Kernels::Hash> hashes)
+        : size_(size), chunk_(chunk), hashes_(::std::move(hashes))
+    { }
+
+    ::std::size_t size() const { return size_; }
+    ::std::size_t chunk() const { return chunk_; }
+    const ::std::vector<Kernels::Hash> & hashes() const { return hashes_; }
+
+    /// One line "cpp-verify-digest 1 <size> <chunk>", then one line with 32 hex digits per chunk.
+    friend ::std::ostream & operator<<(::std::ostream & os, const Digest & this_)
+    {
+        // Printing to local stream avoids involuntary manipulation of the std::ostream.
+        ::std::stringstream stream;
+        stream << "cpp-verify-digest 1 " << this_.size_ << ' ' << this_.chunk_ << '\n' << ::std::hex << ::std::setfill('0');
+        for(const Kernels::Hash & h : this_.hashes_)
+            stream << ::std::setw(16) << h.high << ::std::setw(16) << h.low << '\n';
+        return os << stream.str();
+    }
+
+    /// Sets the failbit if the digest is malformed.
+    friend ::std::istream & operator>>(::std::istream & is, Digest & this_)
+    {
+        ::std::string magic;
+        unsigned version = 0;
+        ::std::size_t size = 0, chunk = 0;
+        if(!(is >> magic >> version >> size >> chunk) || magic != "cpp-verify-digest" || version != 1 || chunk == 0)
+        {
+            is.setstate(::std::ios::failbit);
+            return is;
+        }
+
+        // The input isn't trusted: the hashes are stored as they are read (not as many as the header claims), and no word is read beyond the length of one.
+        const ::std::size_t count = size / chunk + (size % chunk != 0);
+        ::std::vector<Kernels::Hash> hashes;
+        for(::std::size_t i = 0; i < count; ++i)
+        {
+            ::std::string digits;
+            Kernels::Hash h{};
+            if(!(is >> ::std::setw(33) >> digits) || digits.size() != 32 || !parse(digits.data(), h.high) || !parse(digits.data() + 16, h.low))
+            {
+                is.setstate(::std::ios::failbit);
+                return is;
+            }
+            hashes.push_back(h);
+        }
+        this_ = Digest(size, chunk, ::std::move(hashes));
+        return is;
+    }
+
+private:
+    static bool parse(const char * digits, ::std::uint64_t & value)
+    {
+        const auto result = ::std::from_chars(digits, digits + 16, value, 16);
+        return result.ec == ::std::errc() && result.ptr == digits + 16;
+    }
+
+    ::std::size_t size_ = 0;
+    ::std::size_t chunk_ = CPP_VERIFY_DIGEST_CHUNK;
+    ::std::vector<Kernels::Hash> hashes_;
+};
+
+/// The digest of `n` bytes, in chunks of `chunk` bytes (which must not be 0).
+inline Digest digest(const void * data, const ::std::size_t n, const ::std::size_t chunk = CPP_VERIFY_DIGEST_CHUNK)
+{
+    const auto * const bytes = static_cast<const unsigned char *>(data);
+    ::std::vector<Kernels::Hash> hashes;
+    hashes.reserve(n / chunk + 1);
+    for(::std::size_t offset = 0; offset < n; offset += chunk)
+        hashes.push_back(Kernels::hash(bytes + offset, (n - offset < chunk) ? (n - offset) : chunk));
+    return Digest(n, chunk, ::std::move(hashes));
+}
+
+/// The digest of a contiguous container (e.g. a `std::vector` or `std::string`).
+template<typename C>
+auto digest(const C & container, const ::std::size_t chunk = CPP_VERIFY_DIGEST_CHUNK) -> decltype(::std::data(container), ::std::size(container), Digest())
+{
+    return digest(::std::data(container), ::std::size(container) * sizeof(*::std::data(container)), chunk);
+}
+
+
+/// Reads the reference bytes from a file, on demand.
+struct ReferenceFile
+{
+    ::std::string path;
+
+    bool operator()(const ::std::size_t offset, unsigned char * bytes, const ::std::size_t n) const
+    {
+        ::std::ifstream file(path, ::std::ios::binary);
+        file.seekg(static_cast<::std::streamoff>(offset));
+        file.read(reinterpret_cast<char *>(bytes), static_cast<::std::streamsize>(n));
+        return file && static_cast<::std::size_t>(file.gcount()) == n;
+    }
+};
+
+inline ReferenceFile reference_file(::std::string path) { return ReferenceFile{::std::move(path)}; }
+
+/// Stands in, where no reference is given.
+struct NoReference
+{
+    bool operator()(::std::size_t, unsigned char *, ::std::size_t) const { return false; }
+};
+
+
+#if CPP_VERIFY_DECOMPOSE
+
+struct ContentExpression
+{
+    static constexpr const char * macro = "verify_same_content";
+
+    /// What became of the reference, for the chunk that differs.
+    enum class Reference { none, unavailable, differs, agrees };
+
+    ::std::size_t size;     ///< Amount of bytes checked.
+    ::std::size_t expected; ///< Amount of bytes in the digest.
+    ::std::size_t chunk;    ///< Size of the chunks.
+    ::std::size_t chunks;   ///< Amount of chunks (of the larger side).
+    ::std::size_t first;    ///< Index of the first chunk that differs, or `chunks` if none does.
+    Reference reference;
+    BytesExpression bytes;  ///< The first difference in that chunk, if the reference differs as well.
+
+    constexpr bool evaluate() const { return (first == chunks) && (size == expected); }
+
+    friend ::std::ostream & operator<<(::std::ostream & os, const ContentExpression & this_)
+    {
+        os << this_.size << " bytes";
+        if(this_.size != this_.expected)
+            os << " vs. " << this_.expected << " bytes in the digest";
+        if(this_.evaluate())
+            return os << ", " << this_.chunks << " chunks as in the digest";
+
+        const ::std::size_t begin = this_.first * this_.chunk;
+        const ::std::size_t end = begin + this_.chunk;
+        os << ", chunk " << this_.first << " of " << this_.chunks;
+        if(begin >= this_.size)
+            return os << " is missing";
+        if(begin >= this_.expected)
+            return os << " is not in the digest";
+
+        os << " differs from the digest";
+        switch(this_.reference)
+        {
+            case Reference::differs:
+                return os << ", " << this_.bytes;
+            case Reference::agrees:
+                return os << ", but the reference agrees with its bytes [" << begin << ", " << ((this_.size < end) ? this_.size : end) << ')';
+            case Reference::unavailable:
+                os << " (the reference is not available)";
+                break;
+            case Reference::none:
+                break;
+        }
+        return os << " at bytes [" << begin << ", " << ((this_.size < end) ? this_.size : end) << ')';
+    }
+};
+
+#endif // CPP_VERIFY_DECOMPOSE
+
+
+/// Hash the chunks of the `n` bytes at `data`, and stop at the first one that differs from the digest.
+/// Only then read that chunk from the reference, to find the first difference in it.
+template<typename Reference>
+auto compare_content(const char * code, const void * data, const ::std::size_t n, const Digest & expected, const Reference & reference)
+{
+    const auto * const bytes = static_cast<const unsigned char *>(data);
+    const ::std::size_t chunk = expected.chunk();
+    const ::std::size_t own = n / chunk + (n % chunk != 0);
+    const ::std::size_t theirs = expected.hashes().size();
+    const ::std::size_t common = (own < theirs) ? own : theirs;
+
+    ::std::size_t first = 0;
+    for(; first < common; ++first)
+    {
+        const ::std::size_t offset = first * chunk;
+        if(Kernels::hash(bytes + offset, (n - offset < chunk) ? (n - offset) : chunk) != expected.hashes()[first])
+            break;
+    }
+
+#if CPP_VERIFY_DECOMPOSE
+    const ::std::size_t chunks = (own > theirs) ? own : theirs;
+    using R = ContentExpression::Reference;
+    ContentExpression x{n, expected.size(), chunk, chunks, first, R::none, {n, n, 0, 0, 0, {}, {}}};
+    if(first < common && !::std::is_same<Reference, NoReference>::value)
+    {
+        const ::std::size_t offset = first * chunk;
+        const ::std::size_t length = (n - offset < chunk) ? (n - offset) : chunk;
+        const ::std::size_t other = (expected.size() - offset < chunk) ? (expected.size() - offset) : chunk;
+        ::std::vector<unsigned char> loaded(other);
+        x.reference = R::unavailable;
+        if(reference(offset, loaded.data(), other))
+        {
+            // The window is framed within the chunk, then moved to where the chunk is.
+            const ::std::size_t shorter = (length < other) ? length : other;
+            BytesExpression & b = x.bytes;
+            b = BytesExpression{shorter, Kernels::find_mismatch(bytes + offset, loaded.data(), shorter), 0, 0, 0, {}, {}};
+            x.reference = (b.first < shorter) ? R::differs : R::agrees;
+            if(x.reference == R::differs)
+            {
+                frame(b, bytes + offset, loaded.data());
+                b.size = n;
+                b.first += offset;
+                b.start += offset;
+            }
+        }
+    }
+    return make_decomposition(code, x);
+#else
+    static_cast<void>(reference);
+    return Condition(code, first == common && n == expected.size());
+#endif
+}
+
+inline auto check_content(const char * code, const void * data, const ::std::size_t n, const Digest & expected)
+{
+    return compare_content(code, data, n, expected, NoReference());
+}
+
+template<typename Reference>
+auto check_content(const char * code, const void * data, const ::std::size_t n, const Digest & expected, const Reference & reference)
+{
+    return compare_content(code, data, n, expected, reference);
+}
+
+template<typename C>
+auto check_content(const char * code, const C & container, const Digest & expected) -> decltype(::std::data(container), ::std::size(container), compare_content(code, nullptr, 0, expected, NoReference()))
+{
+    return compare_content(code, ::std::data(container), ::std::size(container) * sizeof(*::std::data(container)), expected, NoReference());
+}
+
+template<typename C, typename Reference>
+auto check_content(const char * code, const C & container, const Digest & expected, const Reference & reference) -> decltype(::std::data(container), ::std::size(container), compare_content(code, nullptr, 0, expected, reference))
+{
+    return compare_content(code, ::std::data(container), ::std::size(container) * sizeof(*::std::data(container)), expected, reference);
+}
+
+}
+
+#endif
@@ -0,0 +1,308 @@
+//////
+/// \file     verify-failure.hpp
+/// \brief    Provide `CppVerify::Failure`, a single type for any result of verify(), to be rendered later (e.g. on another thread).
+///
+/// \details  Every result of verify() has its own type (e.g. `Decomposition<BinaryExpression<int, LT, int>>`),
+///           so a queue of them would have to hold strings, formatted by the producer.
+///           A `Failure` holds any of them instead, alongside the site of the check:
+///           ```
+///           if(auto fail = !verify(price > 0))
+///               failures.push(CppVerify::Failure(fail, __FILE__, __LINE__));
+///           ...
+///           std::cerr << failures.front(); // "orders.cpp:42: !verify(price > 0) => !verify(-1 > 0) => true"
+///           ```
+///           The result is kept in `CPP_VERIFY_FAILURE_INLINE` bytes (64 by default) inside the `Failure`,
+///           and only spills onto the heap if it is larger than that. It is rendered when the `Failure` is printed,
+///           through a function pointer for its type. Thus, for small operands, the producer pays a copy, but no formatting.
+///
+///           Operands that the result refers to (see `Capture`) are copied into the `Failure`, so it does not depend
+///           on them (nor on any temporaries) anymore. Character pointers, arrays and string views are copied as `std::string`.
+///           Thus, the producer pays for such copies, e.g. a heap allocation for a long `std::string`.
+///           Operands that the result owns are moved instead, if the result is passed as an rvalue. That's the temporaries
+///           of verify_owned(), and of the deferred side of an aggregation (see verify_lazily()):
+///           ```
+///           failures.push(CppVerify::Failure(!verify_owned(make_name() == "expected"))); // Moves the name.
+///           ```
+///           Operands that cannot be copied at all (or arrays, except of characters) are rendered right away, as a fallback.
+//////
+
+#ifndef CPP_VERIFY_FAILURE_HPP
+#define CPP_VERIFY_FAILURE_HPP
+
+#include "verify.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#ifndef CPP_VERIFY_FAILURE_INLINE
+    #define CPP_VERIFY_FAILURE_INLINE 64
+#endif
+
+namespace CppVerify {
+
+/// A result, rendered right away, because its operands can't be copied.
+struct Rendered
+{
+    ::std::string text;
+
+    friend ::std::ostream & operator<<(::std::ostream & os, const Rendered & this_) { return os << this_.text; }
+};
+
+
+/// How a `Failure` keeps a result: by default, just as it is, since it doesn't refer to anything (e.g. `Condition`, or verify_all()).
+template<typename Result, typename = void> struct Portable
+{
+    using type = Result;
+
+    template<typename Source> static type take(Source && result) { return ::std::forward<Source>(result); }
+};
+
+template<typename Result> using portable_t = typename Portable<Result>::type;
+
+
+/// Aggregations keep both of their sides portable.
+template<template<class, class, class> class J, class C, class L, class R>
+struct Portable<J<C, L, R>, typename ::std::enable_if<is_result<J<C, L, R>>::value>::type>
+{
+    using type = J<C, portable_t<L>, portable_t<R>>;
+
+    template<typename Source> static type take(Source && result)
+    {
+        ::std::optional<portable_t<R>> rhs;
+        if(result.rhs)
+            rhs.emplace(Portable<R>::take(*::std::forward<Source>(result).rhs));
+        return type(Portable<L>::take(::std::forward<Source>(result).lhs), result.rhs_code, ::std::move(rhs), result.value);
+    }
+};
+
+
+#if CPP_VERIFY_DECOMPOSE
+
+template<typename T> struct is_string_view : ::std::false_type { };
+template<typename Traits> struct is_string_view<::std::basic_string_view<char, Traits>> : ::std::true_type { };
+
+/// How a `Failure` keeps an operand (of its captured type `T`): small ones by value, all others owned -- strings as `std::string`.
+template<typename T, typename = void> struct PortableOperand
+{
+    using O = typename ::std::remove_cv<operand_t<T>>::type;
+
+    static constexpr bool copyable = ::std::is_copy_constructible<O>::value && !::std::is_array<O>::value;
+
+    using type = typename ::std::conditional<Capture<T>::by_value && !is_owned<T>::value, T, Owned<O>>::type;
+
+    /// Copies the operand, or moves it, if it's owned by an rvalue.
+    template<typename Source> static O take(Source && operand) { return ::std::forward<Source>(operand); }
+};
+
+/// Characters that are only referred to, even if they're captured by value (like pointers and views).
+template<typename T> struct PortableOperand<T, typename ::std::enable_if<
+    is_string<typename ::std::remove_cv<operand_t<T>>::type>::value && !::std::is_class<typename ::std::remove_cv<operand_t<T>>::type>::value>::type>
+{
+    static constexpr bool copyable = true;
+
+    using type = Owned<::std::string>;
+
+    /// Null pointers become empty strings.
+    template<typename Source> static ::std::string take(const Source & operand) { return is_null_string(operand) ? ::std::string() : ::std::string(operand); }
+};
+
+template<typename T> struct PortableOperand<T, typename ::std::enable_if<is_string_view<typename ::std::remove_cv<operand_t<T>>::type>::value>::type>
+{
+    static constexpr bool copyable = true;
+
+    using type = Owned<::std::string>;
+
+    template<typename Source> static ::std::string take(const Source & operand) { return ::std::string(operand); }
+};
+
+template<typename T> using portable_operand_t = typename PortableOperand<T>::type;
+
+
+template<typename Result> Rendered render(const Result & result)
+{
+    ::std::ostringstream stream;
+    stream << result;
+    return Rendered{stream.str()};
+}
+
+/// Results of verify() (and their negations) copy the operands they refer to.
+template<template<class> class D, typename T>
+struct Portable<D<UnaryExpression<T>>, typename ::std::enable_if<is_result<D<UnaryExpression<T>>>::value>::type>
+{
+    static constexpr bool copyable = PortableOperand<T>::copyable;
+
+    using Expression = UnaryExpression<portable_operand_t<T>>;
+    using type = typename ::std::conditional<copyable, D<Expression>, Rendered>::type;
+
+    template<typename Source> static type take(Source && result)
+    {
+        if constexpr(copyable)
+            return type(result.code, Expression(PortableOperand<T>::take(::std::forward<Source>(result).expression.operand)), result.value());
+        else
+            return render(result);
+    }
+};
+
+template<template<class> class D, typename L, typename Comparison, typename R>
+struct Portable<D<BinaryExpression<L, Comparison, R>>, typename ::std::enable_if<is_result<D<BinaryExpression<L, Comparison, R>>>::value>::type>
+{
+    static constexpr bool copyable = PortableOperand<L>::copyable && PortableOperand<R>::copyable;
+
+    using Expression = BinaryExpression<portable_operand_t<L>, Comparison, portable_operand_t<R>>;
+    using type = typename ::std::conditional<copyable, D<Expression>, Rendered>::type;
+
+    template<typename Source> static type take(Source && result)
+    {
+        if constexpr(copyable)
+            return type(result.code, Expression(PortableOperand<L>::take(::std::forward<Source>(result).expression.operand1),
+                                                PortableOperand<R>::take(::std::forward<Source>(result).expression.operand2)), result.value());
+        else
+            return render(result);
+    }
+};
+
+#endif // CPP_VERIFY_DECOMPOSE
+
+
+/// Any result of verify() (or an aggregation thereof), with the site of the check, in a single type.
+/// The result is kept inline, if it fits into `CPP_VERIFY_FAILURE_INLINE` bytes, else on the heap. It is rendered only when printed.
+class Failure
+{
+public:
+    static constexpr ::std::size_t capacity = CPP_VERIFY_FAILURE_INLINE;
+
+    template<typename Result, typename = typename ::std::enable_if<is_result<typename ::std::decay<Result>::type>::value>::type>
+    explicit Failure(Result && result, const char * file = nullptr, unsigned line = 0) : file_(file), line_(line)
+    {
+        using Kept = portable_t<typename ::std::decay<Result>::type>;
+        using Source = Portable<typename ::std::decay<Result>::type>;
+        if constexpr(fits<Kept>())
+        {
+            ::new(static_cast<void *>(storage)) Kept(Source::take(::std::forward<Result>(result)));
+            operations = &Inline<Kept>::operations;
+        }
+        else
+        {
+            ::new(static_cast<void *>(storage)) Kept *(new Kept(Source::take(::std::forward<Result>(result))));
+            operations = &OnHeap<Kept>::operations;
+        }
+    }
+
+    Failure(Failure && other) noexcept : operations(other.operations), file_(other.file_), line_(other.line_)
+    {
+        if(operations)
+            operations->relocate(storage, other.storage);
+        other.operations = nullptr;
+    }
+
+    Failure & operator=(Failure && other) noexcept
+    {
+        if(this != &other)
+        {
+            reset();
+            operations = other.operations;
+            file_ = other.file_;
+            line_ = other.line_;
+            if(operations)
+                operations->relocate(storage, other.storage);
+            other.operations = nullptr;
+        }
+        return *this;
+    }
+
+    Failure() = delete;
+    Failure(const Failure &) = delete;
+    Failure & operator=(const Failure &) = delete;
+    ~Failure() { reset(); }
+
+    const char * file() const { return file_; }
+    unsigned line() const { return line_; }
+
+    /// Whether the result didn't fit inline.
+    bool on_heap() const { return operations && operations->on_heap; }
+
+    friend ::std::ostream & operator<<(::std::ostream & os, const Failure & this_)
+    {
+        // Printing to local stream avoids involuntary manipulation of the std::ostream.
+        ::std::stringstream stream;
+        if(this_.file_)
+            stream << this_.file_ << ':' << this_.line_ << ": ";
+        if(this_.operations)
+            this_.operations->print(stream, this_.storage);
+        return os << stream.str();
+    }
+
+private:
+    struct Operations
+    {
+        void (*print)(::std::ostream &, const void *);
+        void (*relocate)(void * to, void * from) noexcept; ///< Move-construct at `to`, and destroy at `from`.
+        void (*destroy)(void *) noexcept;
+        bool on_heap;
+    };
+
+    template<typename Kept> static constexpr bool fits()
+    {
+        return sizeof(Kept) <= capacity && alignof(Kept) <= alignof(::std::max_align_t) && ::std::is_nothrow_move_constructible<Kept>::value;
+    }
+
+    template<typename Kept> struct Inline
+    {
+        static const Kept & kept(const void * storage) { return *::std::launder(static_cast<const Kept *>(storage)); }
+
+        static void print(::std::ostream & os, const void * storage) { os << kept(storage); }
+
+        static void relocate(void * to, void * from) noexcept
+        {
+            if constexpr(::std::is_trivially_copyable<Kept>::value)
+                ::std::memcpy(to, from, sizeof(Kept));
+            else
+            {
+                Kept & source = *::std::launder(static_cast<Kept *>(from));
+                ::new(to) Kept(::std::move(source));
+                source.~Kept();
+            }
+        }
+
+        static void destroy(void * storage) noexcept { ::std::launder(static_cast<Kept *>(storage))->~Kept(); }
+
+        static constexpr Operations operations{&print, &relocate, &destroy, false};
+    };
+
+    template<typename Kept> struct OnHeap
+    {
+        static Kept * kept(const void * storage) { return *::std::launder(static_cast<Kept * const *>(storage)); }
+
+        static void print(::std::ostream & os, const void * storage) { os << *kept(storage); }
+
+        static void relocate(void * to, void * from) noexcept { ::new(to) Kept *(kept(from)); }
+
+        static void destroy(void * storage) noexcept { delete kept(storage); }
+
+        static constexpr Operations operations{&print, &relocate, &destroy, true};
+    };
+
+    void reset() noexcept
+    {
+        if(operations)
+            operations->destroy(storage);
+        operations = nullptr;
+    }
+
+    alignas(::std::max_align_t) unsigned char storage[capacity];
+    const Operations * operations;
+    const char * file_;
+    unsigned line_;
+};
+
+}
+
+#endif
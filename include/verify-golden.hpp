@@ -0,0 +1,160 @@
+//////
+/// \file     verify-golden.hpp
+/// \brief    Provide the verify_matches_golden() function, that compares generated output against a reference ("golden") file.
+///
+/// \details  `verify_matches_golden(output, path)` maps the golden file read-only (see `MappedFile`),
+///           and compares it with the vectorized kernels of verify_bytes_equal(), i.e. without reading it into a string:
+///           ```
+///           const std::string report = render(document);
+///           std::cout << verify_matches_golden(report, "golden/report.txt");
+///           ```
+///           will print something like:
+///           ```
+///           verify_matches_golden(report, "golden/report.txt") => verify_matches_golden(differs from golden/report.txt, first difference at offset 6 of 12 bytes
+///             actual   @0: 48 65 6c 6c 6f 20 77 6f 72 6c 64 21  |Hello world!|
+///             expected @0: 48 65 6c 6c 6f 20 57 6f 72 6c 64 21  |Hello World!|
+///                                             ^^
+///           ) => false
+///           ```
+///           The output is a contiguous container (e.g. `std::string` or `std::vector<char>`), or a pointer and a size.
+///           The path is a `const char *`, or anything with `c_str()` (e.g. `std::string`).
+///
+///           With `CppVerify::write_new`, a failing check also writes the output beside the golden file, as "<path>.new"
+///           (e.g. for review, or to replace the golden file), and says so:
+///           `verify_matches_golden(report, "golden/report.txt", CppVerify::write_new)`.
+///
+///           A passing check allocates nothing: the golden file's pages come from the page cache, and only the path is kept on failure.
+///           With `CPP_VERIFY_DECOMPOSE=0`, only the code is kept alongside the boolean result.
+//////
+
+#ifndef CPP_VERIFY_GOLDEN_HPP
+#define CPP_VERIFY_GOLDEN_HPP
+
+#include "verify.hpp"
+#include "verify-kernels.hpp"
+#include "verify-bytes.hpp"
+#include "verify-mapped.hpp"
+
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#define verify_matches_golden(...) (CppVerify::check_golden(#__VA_ARGS__, __VA_ARGS__))
+
+namespace CppVerify {
+
+/// Tag to have verify_matches_golden() write the output beside the golden file, if they differ.
+struct WriteNew { };
+constexpr WriteNew write_new{};
+
+
+#if CPP_VERIFY_DECOMPOSE
+
+struct GoldenExpression
+{
+    static constexpr const char * macro = "verify_matches_golden";
+
+    ::std::size_t size;     ///< Amount of bytes of the output.
+    ::std::size_t expected; ///< Amount of bytes of the golden file.
+    int error;              ///< The `errno` of mapping the golden file, or 0.
+    bool written;           ///< Whether the output was written beside the golden file.
+    BytesExpression bytes;  ///< The first difference within the shorter of both.
+    ::std::string path;     ///< The golden file, if the check failed.
+
+    bool evaluate() const { return (error == 0) && (size == expected) && bytes.evaluate(); }
+
+    friend ::std::ostream & operator<<(::std::ostream & os, const GoldenExpression & this_)
+    {
+        if(this_.evaluate())
+            return os << this_.size << " bytes as in the golden file";
+
+        if(this_.error != 0)
+            os << "golden file " << this_.path << " not readable (" << ::std::generic_category().message(this_.error) << ')';
+        else if(this_.size != this_.expected)
+            os << this_.size << " bytes vs. " << this_.expected << " bytes in " << this_.path;
+        else
+            os << "differs from " << this_.path;
+        if(this_.written)
+            os << " (new output in " << this_.path << ".new)";
+        if(this_.error != 0)
+            return os;
+        if(!this_.bytes.evaluate())
+            return os << ", " << this_.bytes;
+        return os << ", equal up to offset " << this_.bytes.size;
+    }
+};
+
+#endif // CPP_VERIFY_DECOMPOSE
+
+
+template<typename P> const char * path_of(const P & path)
+{
+    if constexpr(::std::is_convertible<const P &, const char *>::value)
+        return path;
+    else
+        return path.c_str();
+}
+
+/// Compare the `n` bytes at `data` with the golden file at `path`, and (on request) write them beside it, if they differ.
+inline auto compare_golden(const char * code, const void * data, const ::std::size_t n, const char * path, const bool write)
+{
+    const auto * const a = static_cast<const unsigned char *>(data);
+    const MappedFile golden(path);
+    const ::std::size_t shorter = (n < golden.size()) ? n : golden.size();
+    const ::std::size_t first = golden ? Kernels::find_mismatch(a, golden.data(), shorter) : 0;
+    const bool pass = golden && (n == golden.size()) && (first == shorter);
+
+    bool written = false;
+    if(!pass && write)
+    {
+        ::std::ofstream file(::std::string(path) + ".new", ::std::ios::binary | ::std::ios::trunc);
+        written = static_cast<bool>(file.write(reinterpret_cast<const char *>(a), static_cast<::std::streamsize>(n)));
+    }
+
+#if CPP_VERIFY_DECOMPOSE
+    GoldenExpression x{n, golden.size(), golden.error(), written, {shorter, first, 0, 0, 0, {}, {}}, {}};
+    if(!pass)
+    {
+        x.path = path;
+        if(first < shorter)
+            frame(x.bytes, a, golden.data());
+    }
+    return make_decomposition(code, ::std::move(x));
+#else
+    static_cast<void>(written);
+    return Condition(code, pass);
+#endif
+}
+
+template<typename P>
+auto check_golden(const char * code, const void * data, const ::std::size_t n, const P & path)
+{
+    return compare_golden(code, data, n, path_of(path), false);
+}
+
+template<typename P>
+auto check_golden(const char * code, const void * data, const ::std::size_t n, const P & path, WriteNew)
+{
+    return compare_golden(code, data, n, path_of(path), true);
+}
+
+template<typename C, typename P>
+auto check_golden(const char * code, const C & output, const P & path) -> decltype(::std::data(output), ::std::size(output), compare_golden(code, nullptr, 0, nullptr, false))
+{
+    return compare_golden(code, ::std::data(output), ::std::size(output) * sizeof(*::std::data(output)), path_of(path), false);
+}
+
+template<typename C, typename P>
+auto check_golden(const char * code, const C & output, const P & path, WriteNew) -> decltype(::std::data(output), ::std::size(output), compare_golden(code, nullptr, 0, nullptr, false))
+{
+    return compare_golden(code, ::std::data(output), ::std::size(output) * sizeof(*::std::data(output)), path_of(path), true);
+}
+
+}
+
+#endif
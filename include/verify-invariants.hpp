@@ -0,0 +1,201 @@
+//////
+/// \file     verify-invariants.hpp
+/// \brief    Provide verify_sorted(), verify_unique(), verify_partitioned() and verify_heap() for algorithmic invariants of arrays.
+///
+/// \details  Like `std::is_sorted()` and its relatives, but the result names the first violating pair of elements, with indices and values:
+///           ```
+///           std::vector<int> keys = {1, 2, 5, 3};
+///           std::cout << verify_sorted(keys);
+///           ```
+///           will print something like: "verify_sorted(keys) => verify_sorted([2]: 5, [3]: 3 out of order) => false".
+///
+///           - `verify_sorted(range)` and `verify_sorted(range, comp)` hold where `std::is_sorted()` holds.
+///           - `verify_unique(range)` holds if no two adjacent elements are equal (i.e. for sorted ranges: all elements are distinct).
+///           - `verify_partitioned(range, pred)` holds where `std::is_partitioned()` holds.
+///           - `verify_heap(range)` and `verify_heap(range, comp)` hold where `std::is_heap()` holds.
+///
+///           Sortedness and uniqueness of arithmetic elements are checked by the vectorized kernels of verify_all(),
+///           comparing the array to itself, shifted by one element. This applies to the comparisons `std::less` and `std::greater`.
+///           Any other comparison (or predicate) is applied element by element.
+///
+///           With `CPP_VERIFY_DECOMPOSE=0`, only the code is kept alongside the boolean result.
+//////
+
+#ifndef CPP_VERIFY_INVARIANTS_HPP
+#define CPP_VERIFY_INVARIANTS_HPP
+
+#include "verify.hpp"
+#include "verify-all.hpp"
+#include "verify-kernels.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <ostream>
+#include <type_traits>
+
+#define verify_sorted(...)      (CppVerify::check_invariant<CppVerify::Sorted>     (#__VA_ARGS__, __VA_ARGS__))
+#define verify_unique(...)      (CppVerify::check_invariant<CppVerify::Unique>     (#__VA_ARGS__, __VA_ARGS__))
+#define verify_partitioned(...) (CppVerify::check_invariant<CppVerify::Partitioned>(#__VA_ARGS__, __VA_ARGS__))
+#define verify_heap(...)        (CppVerify::check_invariant<CppVerify::Heap>       (#__VA_ARGS__, __VA_ARGS__))
+
+namespace CppVerify {
+
+/// Index of the first violating pair, or `n` if there is none.
+struct Violation
+{
+    ::std::size_t first;
+    ::std::size_t second;
+};
+
+
+//////
+// == Invariants ==
+//
+// Each finds its first violation in `n` elements at `a` (given a comparison or predicate),
+// and names itself and its outcome for printing.
+
+/// Whether `Compare` is `std::less` or `std::greater` (for any, or exactly this element type), and which tag the kernels use for it:
+/// A sorted array holds `a[i] <= a[i + 1]` (respectively `>=`) for all `i`.
+template<typename Compare, typename T> struct AdjacentTag { using type = void; };
+template<typename T> struct AdjacentTag<::std::less<T>,    T> { using type = LE; };
+template<typename T> struct AdjacentTag<::std::less<>,     T> { using type = LE; };
+template<typename T> struct AdjacentTag<::std::greater<T>, T> { using type = GE; };
+template<typename T> struct AdjacentTag<::std::greater<>,  T> { using type = GE; };
+
+struct Sorted
+{
+    static constexpr const char * macro = "verify_sorted";
+    static constexpr const char * pass = "in order";
+    static constexpr const char * fail = "out of order";
+
+    template<typename T, typename Compare = ::std::less<>>
+    static Violation find(const T * a, const ::std::size_t n, Compare comp = Compare())
+    {
+        if(n < 2)
+            return Violation{n, n};
+
+        ::std::size_t i = 0;
+        using Tag = typename AdjacentTag<Compare, T>::type;
+        if constexpr(!::std::is_void<Tag>::value && Kernels::is_vectorizable<T>::value)
+        {
+            // The kernels find the first pair with `!(a[i] <= a[i + 1])`. That is a violation indeed, unless NaN is involved.
+            for(;;)
+            {
+                i += Kernels::find_first<Tag>(a + i, Kernels::Array<T>{a + i + 1}, n - 1 - i);
+                if(i == n - 1 || comp(a[i + 1], a[i]))
+                    break;
+                ++i;
+            }
+        }
+        else
+            i = static_cast<::std::size_t>(::std::is_sorted_until(a, a + n, comp) - a) - 1;
+
+        return (i < n - 1) ? Violation{i, i + 1} : Violation{n, n};
+    }
+};
+
+struct Unique
+{
+    static constexpr const char * macro = "verify_unique";
+    static constexpr const char * pass = "without adjacent duplicates";
+    static constexpr const char * fail = "are adjacent duplicates";
+
+    template<typename T>
+    static Violation find(const T * a, const ::std::size_t n)
+    {
+        if(n < 2)
+            return Violation{n, n};
+
+        // No pair may hold `a[i] == a[i + 1]`, i.e. all must hold `a[i] != a[i + 1]` (even NaN).
+        const ::std::size_t i = Kernels::find_first<NE>(a, Kernels::Array<T>{a + 1}, n - 1);
+        return (i < n - 1) ? Violation{i, i + 1} : Violation{n, n};
+    }
+};
+
+struct Partitioned
+{
+    static constexpr const char * macro = "verify_partitioned";
+    static constexpr const char * pass = "partitioned";
+    static constexpr const char * fail = "violate the partition";
+
+    template<typename T, typename Predicate>
+    static Violation find(const T * a, const ::std::size_t n, Predicate pred)
+    {
+        // The first element that fails the predicate, and the first one that satisfies it thereafter.
+        ::std::size_t i = 0;
+        while(i < n && pred(a[i]))
+            ++i;
+        ::std::size_t j = i + 1;
+        while(j < n && !pred(a[j]))
+            ++j;
+        return (j < n) ? Violation{i, j} : Violation{n, n};
+    }
+};
+
+struct Heap
+{
+    static constexpr const char * macro = "verify_heap";
+    static constexpr const char * pass = "in heap order";
+    static constexpr const char * fail = "violate the heap order";
+
+    template<typename T, typename Compare = ::std::less<>>
+    static Violation find(const T * a, const ::std::size_t n, Compare comp = Compare())
+    {
+        // The first child that precedes its parent.
+        const ::std::size_t child = static_cast<::std::size_t>(::std::is_heap_until(a, a + n, comp) - a);
+        return (child < n) ? Violation{(child - 1) / 2, child} : Violation{n, n};
+    }
+};
+
+
+#if CPP_VERIFY_DECOMPOSE
+
+template<typename Invariant, typename T> struct InvariantExpression
+{
+    static constexpr const char * macro = Invariant::macro;
+
+    const ::std::size_t size;       ///< Amount of elements.
+    const Violation violation;      ///< Indices of the first violating pair (or `size`, if none).
+    const ::std::optional<T> op1;   ///< Copy of the first element of the violating pair.
+    const ::std::optional<T> op2;   ///< Copy of the second element of the violating pair.
+
+    constexpr bool evaluate() const { return (violation.first == size); }
+
+    friend ::std::ostream & operator<<(::std::ostream & os, const InvariantExpression & this_)
+    {
+        if(this_.evaluate())
+            return os << this_.size << " elements " << Invariant::pass;
+        return os << '[' << this_.violation.first << "]: " << *this_.op1 << ", [" << this_.violation.second << "]: " << *this_.op2 << ' ' << Invariant::fail;
+    }
+};
+
+#endif // CPP_VERIFY_DECOMPOSE
+
+
+/// Check an invariant of a contiguous range, with optional further arguments (a comparison or predicate).
+template<typename Invariant, typename Range, typename... Args>
+auto check_invariant(const char * code, const Range & range, const Args &... args)
+{
+    using T = element_t<Range>;
+    const T * const a = ::std::data(range);
+    const ::std::size_t n = ::std::size(range);
+    const Violation violation = Invariant::find(a, n, args...);
+
+#if CPP_VERIFY_DECOMPOSE
+    const bool found = (violation.first < n);
+    return make_decomposition(code, InvariantExpression<Invariant, T>{
+        n, violation,
+        found ? ::std::optional<T>(a[violation.first]) : ::std::nullopt,
+        found ? ::std::optional<T>(a[violation.second]) : ::std::nullopt
+    });
+#else
+    return Condition(code, violation.first == n);
+#endif
+}
+
+}
+
+#endif
@@ -0,0 +1,679 @@
+//////
+/// \file     verify-kernels.hpp
+/// \brief    Vectorized kernels for checks over whole arrays, e.g. verify_all().
+///
+/// \details  The kernels are written once, with GNU vector extensions, and instantiated per instruction set
+///           (SSE2, AVX2, AVX-512) via function target attributes. The best instruction set is detected at run-time.
+///           Without GNU extensions, or on other architectures, the kernels fall back onto scalar loops.
+///
+///           Defining `CPP_VERIFY_SIMD=0` disables the vectorized kernels altogether.
+///           `CppVerify::Kernels::isa()` may also be lowered at run-time (e.g. for testing the fallbacks).
+///
+///           The AVX-512 kernels are only chosen by default with `CPP_VERIFY_SIMD_AVX512=1`:
+///           Many CPUs split or down-clock 512-bit vectors, so that (memory-bound) scans run slower than with AVX2.
+///
+///           The comparison tags (EQ, NE, LE, GE, LT, GT) are reused: their scalar `evaluate()` for the fallback,
+///           and the same operators lane-wise for the vectors. Therefore, both agree (even for NaN).
+//////
+
+#ifndef CPP_VERIFY_KERNELS_HPP
+#define CPP_VERIFY_KERNELS_HPP
+
+#include "verify.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#ifndef CPP_VERIFY_SIMD
+    #if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+        #define CPP_VERIFY_SIMD 1
+    #else
+        #define CPP_VERIFY_SIMD 0
+    #endif
+#endif
+
+#ifndef CPP_VERIFY_SIMD_AVX512
+    #define CPP_VERIFY_SIMD_AVX512 0
+#endif
+
+#if CPP_VERIFY_SIMD
+    #include <immintrin.h>
+
+    #define CPP_VERIFY__ALWAYS_INLINE inline __attribute__((always_inline))
+    #define CPP_VERIFY__TARGET_AVX2   __attribute__((target("avx2,fma")))
+    #define CPP_VERIFY__TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512dq,avx512vl")))
+    #define CPP_VERIFY__UNROLL        _Pragma("GCC unroll 8")
+#else
+    #define CPP_VERIFY__ALWAYS_INLINE inline
+#endif
+
+namespace CppVerify {
+namespace Kernels {
+
+enum class Isa { scalar, sse2, avx2, avx512 };
+
+inline Isa detected_isa()
+{
+#if CPP_VERIFY_SIMD
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq") && __builtin_cpu_supports("avx512vl"))
+        return Isa::avx512;
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return Isa::avx2;
+    return Isa::sse2; // baseline of x86-64
+#else
+    return Isa::scalar;
+#endif
+}
+
+/// The instruction set used by the kernels: detected once, but may be lowered (or raised up to `detected_isa()`).
+inline Isa & isa()
+{
+    static Isa selected = (CPP_VERIFY_SIMD_AVX512 || detected_isa() < Isa::avx512) ? detected_isa() : Isa::avx2;
+    return selected;
+}
+
+
+/// Arithmetic types map directly onto vector lanes.
+template<typename T> struct is_vectorizable : ::std::integral_constant<bool,
+    ::std::is_arithmetic<T>::value && !::std::is_same<T, bool>::value && !::std::is_same<T, long double>::value && (sizeof(T) <= 8)> { };
+
+
+//////
+// == Sources of the Right-Hand Operand ==
+//
+// Either a single value, or a whole array (of the same length as the left-hand side).
+
+template<typename T> struct Broadcast
+{
+    using element_type = T;
+    static constexpr bool vectorizable = is_vectorizable<T>::value;
+
+    const T value;
+
+    constexpr const T & operator[](::std::size_t) const { return value; }
+
+    template<typename V> CPP_VERIFY__ALWAYS_INLINE void load(V & v, ::std::size_t) const { v = V{} + value; }
+};
+
+template<typename T> struct Array
+{
+    using element_type = T;
+    static constexpr bool vectorizable = is_vectorizable<T>::value;
+
+    const T * const data;
+
+    constexpr const T & operator[](::std::size_t i) const { return data[i]; }
+
+    template<typename V> CPP_VERIFY__ALWAYS_INLINE void load(V & v, ::std::size_t i) const { ::std::memcpy(&v, data + i, sizeof(V)); }
+};
+
+/// Any other (non-vectorizable) value is compared by reference, with the scalar fallback.
+template<typename U> struct Reference
+{
+    using element_type = U;
+    static constexpr bool vectorizable = false;
+
+    const U & value;
+
+    constexpr const U & operator[](::std::size_t) const { return value; }
+};
+
+
+//////
+// == Scalar Kernels ==
+
+template<typename Comparison, typename T, typename Source>
+CPP_VERIFY__ALWAYS_INLINE ::std::size_t find_first_scalar(const T * a, const Source & b, ::std::size_t i, const ::std::size_t n)
+{
+    for(; i < n; ++i)
+        if(!Comparison::evaluate(a[i], b[i]))
+            break;
+    return i;
+}
+
+template<typename Comparison, typename T, typename Source>
+inline ::std::size_t count_scalar(const T * a, const Source & b, ::std::size_t i, const ::std::size_t n)
+{
+    ::std::size_t count = 0;
+    for(; i < n; ++i)
+        count += !Comparison::evaluate(a[i], b[i]);
+    return count;
+}
+
+
+/// How bad an element is: failing elements rank above passing ones, and within each, larger absolute errors above smaller ones, NaN above all.
+/// That is the bit pattern of the error without its sign (so that NaN comes above infinity), and the sign bit set where the element passes.
+template<typename T> using rank_t = typename ::std::conditional<sizeof(T) == 4, ::std::int32_t, ::std::int64_t>::type;
+
+template<typename T> CPP_VERIFY__ALWAYS_INLINE rank_t<T> rank(const T error, const bool fails)
+{
+    rank_t<T> bits;
+    ::std::memcpy(&bits, &error, sizeof(bits));
+    return (bits & ::std::numeric_limits<rank_t<T>>::max()) | (fails ? 0 : ::std::numeric_limits<rank_t<T>>::min());
+}
+
+/// Statistics of the differences between two floating-point arrays, and how many of them exceed the tolerance `atol + rtol * |b[i]|`.
+template<typename T> struct Closeness
+{
+    T max_absolute;         ///< Largest absolute difference `|a[i] - b[i]|` (NaN aside).
+    T max_relative;         ///< Largest relative difference `|a[i] - b[i]| / |b[i]|` (NaN aside).
+    ::std::size_t worst;    ///< Index of the (first) worst element by `rank()`, i.e. a failing one if any, or `n` if all elements are equal.
+    ::std::size_t failures; ///< Amount of elements outside the tolerance (including NaN).
+    rank_t<T> worst_rank = ::std::numeric_limits<rank_t<T>>::min(); ///< The rank of the worst element.
+};
+
+template<typename T>
+CPP_VERIFY__ALWAYS_INLINE void closeness_scalar(Closeness<T> & c, const T * a, const T * b, ::std::size_t i, const ::std::size_t n, const T rtol, const T atol)
+{
+    for(; i < n; ++i)
+    {
+        const T difference = a[i] - b[i];
+        const T error = (difference < 0) ? -difference : difference;
+        const T magnitude = (b[i] < 0) ? -b[i] : b[i];
+        const bool fails = !(a[i] == b[i] || (error <= atol + rtol * magnitude && error < ::std::numeric_limits<T>::infinity()));
+        c.failures += fails;
+        if(error > c.max_absolute)
+            c.max_absolute = error;
+        const rank_t<T> r = rank(error, fails);
+        if(r > c.worst_rank)
+            c.worst_rank = r, c.worst = i;
+        const T relative = error / magnitude;
+        if(relative > c.max_relative)
+            c.max_relative = relative;
+    }
+}
+
+
+//////
+// == Hashing ==
+//
+// A 128-bit hash of bytes, in the manner of XXH3: 16 lanes of 64 bits accumulate stripes of 128 bytes,
+// each lane by `lo32(x ^ key) * hi32(x ^ key) + x'` (where `x'` is the input of the lane 8 places further),
+// and are scrambled after every 16 stripes. Finally, the lanes are folded into two halves of 64 bits each.
+// All instruction sets compute the very same lanes, so the hash doesn't depend on the one used (but on the byte order of the host).
+
+/// A 128-bit hash.
+struct Hash
+{
+    ::std::uint64_t low;
+    ::std::uint64_t high;
+
+    friend constexpr bool operator==(const Hash & a, const Hash & b) { return a.low == b.low && a.high == b.high; }
+    friend constexpr bool operator!=(const Hash & a, const Hash & b) { return !(a == b); }
+};
+
+constexpr ::std::size_t hash_lanes = 16;
+constexpr ::std::size_t hash_stripe = hash_lanes * sizeof(::std::uint64_t);
+constexpr ::std::size_t hash_block = 16; ///< Amount of stripes between scrambles.
+
+constexpr ::std::uint64_t hash_prime32 = 0x9E3779B1u;
+constexpr ::std::uint64_t hash_prime64 = 0x9E3779B185EBCA87u;
+
+struct HashKeys
+{
+    ::std::uint64_t initial[hash_lanes];
+    ::std::uint64_t stripe[hash_block][hash_lanes]; ///< Per stripe of a block, so that swapping stripes changes the hash.
+    ::std::uint64_t scramble[hash_lanes];
+    ::std::uint64_t merge[2][hash_lanes];
+};
+
+/// Fixed pseudo-random keys (from SplitMix64), since hashes may be stored and compared later.
+constexpr HashKeys make_hash_keys()
+{
+    HashKeys keys{};
+    ::std::uint64_t state = 0x6370702D76657269u;
+    const auto next = [&state]() {
+        ::std::uint64_t z = (state += 0x9E3779B97F4A7C15u);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9u;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBu;
+        return z ^ (z >> 31);
+    };
+    for(::std::size_t i = 0; i < hash_lanes; ++i)
+        keys.initial[i] = next();
+    for(::std::size_t s = 0; s < hash_block; ++s)
+        for(::std::size_t i = 0; i < hash_lanes; ++i)
+            keys.stripe[s][i] = next();
+    for(::std::size_t i = 0; i < hash_lanes; ++i)
+        keys.scramble[i] = next();
+    for(::std::size_t h = 0; h < 2; ++h)
+        for(::std::size_t i = 0; i < hash_lanes; ++i)
+            keys.merge[h][i] = next();
+    return keys;
+}
+
+inline constexpr HashKeys hash_keys = make_hash_keys();
+
+CPP_VERIFY__ALWAYS_INLINE void hash_stripe_scalar(::std::uint64_t * acc, const unsigned char * p, const ::std::uint64_t * key)
+{
+    ::std::uint64_t x[hash_lanes];
+    ::std::memcpy(x, p, hash_stripe);
+    for(::std::size_t i = 0; i < hash_lanes; ++i)
+    {
+        const ::std::uint64_t y = x[i] ^ key[i];
+        acc[i] += (y & 0xFFFFFFFFu) * (y >> 32) + x[(i + hash_lanes / 2) % hash_lanes];
+    }
+}
+
+CPP_VERIFY__ALWAYS_INLINE void hash_scramble_scalar(::std::uint64_t * acc)
+{
+    for(::std::size_t i = 0; i < hash_lanes; ++i)
+        acc[i] = ((acc[i] ^ (acc[i] >> 47)) ^ hash_keys.scramble[i]) * hash_prime32;
+}
+
+inline void hash_stripes_scalar(::std::uint64_t * acc, const unsigned char * p, const ::std::size_t stripes)
+{
+    for(::std::size_t s = 0; s < stripes; ++s)
+    {
+        hash_stripe_scalar(acc, p + s * hash_stripe, hash_keys.stripe[s % hash_block]);
+        if(s % hash_block == hash_block - 1)
+            hash_scramble_scalar(acc);
+    }
+}
+
+/// The upper and lower half of the 128-bit product, xor-ed.
+constexpr ::std::uint64_t fold64(const ::std::uint64_t a, const ::std::uint64_t b)
+{
+    const ::std::uint64_t low = (a & 0xFFFFFFFFu) * (b & 0xFFFFFFFFu);
+    const ::std::uint64_t middle1 = (a >> 32) * (b & 0xFFFFFFFFu);
+    const ::std::uint64_t middle2 = (a & 0xFFFFFFFFu) * (b >> 32);
+    const ::std::uint64_t cross = (low >> 32) + (middle1 & 0xFFFFFFFFu) + middle2;
+    const ::std::uint64_t upper = (middle1 >> 32) + (cross >> 32) + (a >> 32) * (b >> 32);
+    return ((cross << 32) | (low & 0xFFFFFFFFu)) ^ upper;
+}
+
+constexpr ::std::uint64_t avalanche(::std::uint64_t h)
+{
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9u;
+    return h ^ (h >> 32);
+}
+
+
+#if CPP_VERIFY_SIMD
+
+//////
+// == Vectorized Kernels ==
+
+
+template<typename T, ::std::size_t Bytes> struct Vector
+{
+    typedef T type __attribute__((vector_size(Bytes)));
+};
+
+template<typename V> CPP_VERIFY__ALWAYS_INLINE void load(V & v, const void * p) { ::std::memcpy(&v, p, sizeof(V)); }
+
+/// One bit per byte of a mask (i.e. the result of a lane-wise comparison), set where the byte's lane is set.
+template<typename Mask> CPP_VERIFY__ALWAYS_INLINE ::std::uint64_t movemask_sse2(const Mask & mask)
+{
+    return static_cast<::std::uint32_t>(_mm_movemask_epi8(reinterpret_cast<const __m128i &>(mask)));
+}
+
+template<typename Mask> CPP_VERIFY__ALWAYS_INLINE CPP_VERIFY__TARGET_AVX2 ::std::uint64_t movemask_avx2(const Mask & mask)
+{
+    return static_cast<::std::uint32_t>(_mm256_movemask_epi8(reinterpret_cast<const __m256i &>(mask)));
+}
+
+template<typename Mask> CPP_VERIFY__ALWAYS_INLINE CPP_VERIFY__TARGET_AVX512 ::std::uint64_t movemask_avx512(const Mask & mask)
+{
+    return _mm512_movepi8_mask(reinterpret_cast<const __m512i &>(mask));
+}
+
+/// The result of `movemask()` with all lanes set.
+template<::std::size_t Bytes> constexpr ::std::uint64_t all_lanes = (Bytes == 64) ? ~::std::uint64_t(0) : ((::std::uint64_t(1) << Bytes) - 1);
+
+/// Skip over passing elements in blocks of four vectors, then locate the first failure (if any) in the scalar tail.
+/// The kernel is defined once per instruction set, because GCC only keeps the wider vectors whole
+/// where the vector operations themselves are compiled for the target (rather than inlined into it).
+#define CPP_VERIFY__DEFINE_FIND_FIRST(name, target, bytes, movemask) \
+    template<typename Comparison, typename T, typename Source> \
+    target ::std::size_t name(const T * a, const Source & b, const ::std::size_t n) \
+    { \
+        using V = typename Vector<T, bytes>::type; \
+        using Mask = decltype(V{} == V{}); \
+        constexpr ::std::size_t lanes = bytes / sizeof(T); \
+        constexpr ::std::size_t block = 4 * lanes; \
+        \
+        /* Peel off the head up to the alignment of the vectors, so that no load splits a cache line. */ \
+        const ::std::size_t misalignment = reinterpret_cast<::std::uintptr_t>(a) % bytes; \
+        const ::std::size_t head = (misalignment % sizeof(T) != 0) ? 0 : ((bytes - misalignment) % bytes) / sizeof(T); \
+        ::std::size_t i = find_first_scalar<Comparison>(a, b, 0, (head < n) ? head : n); \
+        if(i < head) \
+            return i; \
+        for(; i + block <= n; i += block) \
+        { \
+            V x0, x1, x2, x3, y0, y1, y2, y3; \
+            load(x0, a + i);             b.load(y0, i); \
+            load(x1, a + i + lanes);     b.load(y1, i + lanes); \
+            load(x2, a + i + 2 * lanes); b.load(y2, i + 2 * lanes); \
+            load(x3, a + i + 3 * lanes); b.load(y3, i + 3 * lanes); \
+            \
+            Mask mask; \
+            if constexpr(::std::is_same<Comparison, EQ>::value) mask = ((x0 == y0) & (x1 == y1)) & ((x2 == y2) & (x3 == y3)); \
+            if constexpr(::std::is_same<Comparison, NE>::value) mask = ((x0 != y0) & (x1 != y1)) & ((x2 != y2) & (x3 != y3)); \
+            if constexpr(::std::is_same<Comparison, LE>::value) mask = ((x0 <= y0) & (x1 <= y1)) & ((x2 <= y2) & (x3 <= y3)); \
+            if constexpr(::std::is_same<Comparison, GE>::value) mask = ((x0 >= y0) & (x1 >= y1)) & ((x2 >= y2) & (x3 >= y3)); \
+            if constexpr(::std::is_same<Comparison, LT>::value) mask = ((x0 <  y0) & (x1 <  y1)) & ((x2 <  y2) & (x3 <  y3)); \
+            if constexpr(::std::is_same<Comparison, GT>::value) mask = ((x0 >  y0) & (x1 >  y1)) & ((x2 >  y2) & (x3 >  y3)); \
+            if(movemask(mask) != all_lanes<bytes>) \
+                break; \
+        } \
+        \
+        return find_first_scalar<Comparison>(a, b, i, n); \
+    }
+
+CPP_VERIFY__DEFINE_FIND_FIRST(find_first_sse2,   ,                          16, movemask_sse2)
+CPP_VERIFY__DEFINE_FIND_FIRST(find_first_avx2,   CPP_VERIFY__TARGET_AVX2,   32, movemask_avx2)
+CPP_VERIFY__DEFINE_FIND_FIRST(find_first_avx512, CPP_VERIFY__TARGET_AVX512, 64, movemask_avx512)
+
+#undef CPP_VERIFY__DEFINE_FIND_FIRST
+
+/// Skip over equal bytes in blocks of four vectors, then locate the first difference via the movemask of single vectors.
+#define CPP_VERIFY__DEFINE_FIND_MISMATCH(name, target, bytes, movemask) \
+    target inline ::std::size_t name(const unsigned char * a, const unsigned char * b, const ::std::size_t n) \
+    { \
+        using V = Vector<unsigned char, bytes>::type; \
+        \
+        ::std::size_t i = 0; \
+        for(; i + 4 * bytes <= n; i += 4 * bytes) \
+        { \
+            V x0, x1, x2, x3, y0, y1, y2, y3; \
+            load(x0, a + i);             load(y0, b + i); \
+            load(x1, a + i + bytes);     load(y1, b + i + bytes); \
+            load(x2, a + i + 2 * bytes); load(y2, b + i + 2 * bytes); \
+            load(x3, a + i + 3 * bytes); load(y3, b + i + 3 * bytes); \
+            if(movemask(((x0 == y0) & (x1 == y1)) & ((x2 == y2) & (x3 == y3))) != all_lanes<bytes>) \
+                break; \
+        } \
+        for(; i + bytes <= n; i += bytes) \
+        { \
+            V x, y; \
+            load(x, a + i); \
+            load(y, b + i); \
+            const ::std::uint64_t differ = movemask(x == y) ^ all_lanes<bytes>; \
+            if(differ != 0) \
+                return i + static_cast<::std::size_t>(__builtin_ctzll(differ)); \
+        } \
+        while(i < n && a[i] == b[i]) \
+            ++i; \
+        return i; \
+    }
+
+CPP_VERIFY__DEFINE_FIND_MISMATCH(find_mismatch_sse2,   ,                          16, movemask_sse2)
+CPP_VERIFY__DEFINE_FIND_MISMATCH(find_mismatch_avx2,   CPP_VERIFY__TARGET_AVX2,   32, movemask_avx2)
+CPP_VERIFY__DEFINE_FIND_MISMATCH(find_mismatch_avx512, CPP_VERIFY__TARGET_AVX512, 64, movemask_avx512)
+
+#undef CPP_VERIFY__DEFINE_FIND_MISMATCH
+
+/// Gather the statistics of all differences in a single pass, each lane on its own, and merge the lanes at the end.
+/// Infinities are only close to equal infinities, like in `numpy.allclose()`. Where the target has FMA, `atol + rtol * |b[i]|` is fused.
+#define CPP_VERIFY__DEFINE_CLOSENESS(name, target, bytes) \
+    template<typename T> \
+    target Closeness<T> name(const T * a, const T * b, const ::std::size_t n, const T rtol, const T atol) \
+    { \
+        using V = typename Vector<T, bytes>::type; \
+        using Mask = decltype(V{} == V{}); \
+        using Lane = ::std::remove_reference_t<decltype(::std::declval<Mask &>()[0])>; \
+        constexpr ::std::size_t lanes = bytes / sizeof(T); \
+        \
+        constexpr Lane passes = ::std::numeric_limits<Lane>::min(); \
+        \
+        V max_absolute = V{}, max_relative = V{}; \
+        Mask worst = Mask{}, worst_rank = Mask{} + passes, failures = Mask{}, index; \
+        for(::std::size_t l = 0; l < lanes; ++l) \
+            index[l] = static_cast<Lane>(l); \
+        \
+        ::std::size_t i = 0; \
+        for(; i + lanes <= n; i += lanes, index += static_cast<Lane>(lanes)) \
+        { \
+            V x, y; \
+            load(x, a + i); \
+            load(y, b + i); \
+            const V difference = x - y; \
+            const V error = (difference < 0) ? -difference : difference; \
+            const V magnitude = (y < 0) ? -y : y; \
+            const Mask fails = ~((x == y) | ((error <= atol + rtol * magnitude) & (error < ::std::numeric_limits<T>::infinity()))); \
+            failures -= fails; \
+            max_absolute = (error > max_absolute) ? error : max_absolute; \
+            Mask bits; \
+            load(bits, &error); \
+            const Mask rank = (bits & ::std::numeric_limits<Lane>::max()) | (~fails & passes); \
+            const Mask worse = (rank > worst_rank); \
+            worst_rank = worse ? rank : worst_rank; \
+            worst = worse ? index : worst; \
+            const V relative = error / magnitude; \
+            max_relative = (relative > max_relative) ? relative : max_relative; \
+        } \
+        \
+        Closeness<T> c{0, 0, n, 0}; \
+        for(::std::size_t l = 0; l < lanes; ++l) \
+        { \
+            const ::std::size_t at = static_cast<::std::size_t>(worst[l]); \
+            if(worst_rank[l] > c.worst_rank || (worst_rank[l] == c.worst_rank && worst_rank[l] != passes && at < c.worst)) \
+                c.worst_rank = worst_rank[l], c.worst = at; \
+            if(max_absolute[l] > c.max_absolute) \
+                c.max_absolute = max_absolute[l]; \
+            if(max_relative[l] > c.max_relative) \
+                c.max_relative = max_relative[l]; \
+            c.failures += static_cast<::std::size_t>(failures[l]); \
+        } \
+        closeness_scalar(c, a, b, i, n, rtol, atol); \
+        return c; \
+    }
+
+CPP_VERIFY__DEFINE_CLOSENESS(closeness_sse2,   ,                          16)
+CPP_VERIFY__DEFINE_CLOSENESS(closeness_avx2,   CPP_VERIFY__TARGET_AVX2,   32)
+CPP_VERIFY__DEFINE_CLOSENESS(closeness_avx512, CPP_VERIFY__TARGET_AVX512, 64)
+
+#undef CPP_VERIFY__DEFINE_CLOSENESS
+
+/// The products of the lower 32 bits of each 64-bit lane.
+template<typename V> CPP_VERIFY__ALWAYS_INLINE V mul32_sse2(const V & a, const V & b)
+{
+    const __m128i product = _mm_mul_epu32(reinterpret_cast<const __m128i &>(a), reinterpret_cast<const __m128i &>(b));
+    V v;
+    load(v, &product);
+    return v;
+}
+
+template<typename V> CPP_VERIFY__ALWAYS_INLINE CPP_VERIFY__TARGET_AVX2 V mul32_avx2(const V & a, const V & b)
+{
+    const __m256i product = _mm256_mul_epu32(reinterpret_cast<const __m256i &>(a), reinterpret_cast<const __m256i &>(b));
+    V v;
+    load(v, &product);
+    return v;
+}
+
+template<typename V> CPP_VERIFY__ALWAYS_INLINE CPP_VERIFY__TARGET_AVX512 V mul32_avx512(const V & a, const V & b)
+{
+    // The zero-masked form, since the plain one starts from an undefined vector, which GCC 12 warns about.
+    const __m512i product = _mm512_maskz_mul_epu32(0xFF, reinterpret_cast<const __m512i &>(a), reinterpret_cast<const __m512i &>(b));
+    V v;
+    load(v, &product);
+    return v;
+}
+
+/// Accumulate whole stripes, with the lanes of a stripe spread over as many vectors as it takes.
+/// The scramble multiplies by a 32-bit prime, i.e. by two 32-bit products, to get the same (64-bit) result as the scalar lanes.
+#define CPP_VERIFY__DEFINE_HASH_STRIPES(name, target, bytes, mul32) \
+    target inline void name(::std::uint64_t * acc, const unsigned char * p, const ::std::size_t stripes) \
+    { \
+        using V = Vector<::std::uint64_t, bytes>::type; \
+        constexpr ::std::size_t vectors = hash_stripe / bytes; \
+        constexpr ::std::size_t lanes = bytes / sizeof(::std::uint64_t); \
+        \
+        V a[vectors]; \
+        CPP_VERIFY__UNROLL for(::std::size_t j = 0; j < vectors; ++j) \
+            load(a[j], acc + j * lanes); \
+        const V prime = V{} + hash_prime32; \
+        for(::std::size_t s = 0; s < stripes; ++s) \
+        { \
+            const unsigned char * const q = p + s * hash_stripe; \
+            const ::std::uint64_t * const key = hash_keys.stripe[s % hash_block]; \
+            V x[vectors]; \
+            CPP_VERIFY__UNROLL for(::std::size_t j = 0; j < vectors; ++j) \
+                load(x[j], q + j * bytes); \
+            CPP_VERIFY__UNROLL for(::std::size_t j = 0; j < vectors; ++j) \
+            { \
+                V k, y; \
+                load(k, key + j * lanes); \
+                y = x[j] ^ k; \
+                a[j] += mul32(y, y >> 32) + x[(j + vectors / 2) % vectors]; \
+            } \
+            if(s % hash_block == hash_block - 1) \
+            { \
+                CPP_VERIFY__UNROLL for(::std::size_t j = 0; j < vectors; ++j) \
+                { \
+                    V k; \
+                    load(k, hash_keys.scramble + j * lanes); \
+                    const V y = (a[j] ^ (a[j] >> 47)) ^ k; \
+                    a[j] = mul32(y, prime) + (mul32(y >> 32, prime) << 32); \
+                } \
+            } \
+        } \
+        CPP_VERIFY__UNROLL for(::std::size_t j = 0; j < vectors; ++j) \
+            ::std::memcpy(acc + j * lanes, &a[j], bytes); \
+    }
+
+CPP_VERIFY__DEFINE_HASH_STRIPES(hash_stripes_sse2,   ,                          16, mul32_sse2)
+CPP_VERIFY__DEFINE_HASH_STRIPES(hash_stripes_avx2,   CPP_VERIFY__TARGET_AVX2,   32, mul32_avx2)
+CPP_VERIFY__DEFINE_HASH_STRIPES(hash_stripes_avx512, CPP_VERIFY__TARGET_AVX512, 64, mul32_avx512)
+
+#undef CPP_VERIFY__DEFINE_HASH_STRIPES
+
+#endif // CPP_VERIFY_SIMD
+
+
+//////
+// == Dispatch ==
+
+/// Index of the first `i` for which `Comparison::evaluate(a[i], b[i])` fails, or `n`.
+template<typename Comparison, typename T, typename Source>
+inline ::std::size_t find_first(const T * a, const Source & b, const ::std::size_t n)
+{
+#if CPP_VERIFY_SIMD
+    if constexpr(Source::vectorizable && ::std::is_same<typename Source::element_type, T>::value)
+    {
+        switch(isa())
+        {
+            case Isa::avx512: return find_first_avx512<Comparison>(a, b, n);
+            case Isa::avx2:   return find_first_avx2<Comparison>(a, b, n);
+            case Isa::sse2:   return find_first_sse2<Comparison>(a, b, n);
+            case Isa::scalar: break;
+        }
+    }
+#endif
+    return find_first_scalar<Comparison>(a, b, 0, n);
+}
+
+/// Offset of the first byte that differs between `a` and `b`, or `n`.
+inline ::std::size_t find_mismatch(const unsigned char * a, const unsigned char * b, const ::std::size_t n)
+{
+#if CPP_VERIFY_SIMD
+    switch(isa())
+    {
+        case Isa::avx512: return find_mismatch_avx512(a, b, n);
+        case Isa::avx2:   return find_mismatch_avx2(a, b, n);
+        case Isa::sse2:   return find_mismatch_sse2(a, b, n);
+        case Isa::scalar: break;
+    }
+#endif
+    ::std::size_t i = 0;
+    while(i < n && a[i] == b[i])
+        ++i;
+    return i;
+}
+
+/// Amount of bytes that differ between `a` and `b`, from offset `i` on.
+inline ::std::size_t count_mismatches(const unsigned char * a, const unsigned char * b, ::std::size_t i, const ::std::size_t n)
+{
+    ::std::size_t count = 0;
+    for(; i < n; ++i)
+        count += (a[i] != b[i]);
+    return count;
+}
+
+/// The statistics of the differences of `n` floats or doubles.
+template<typename T>
+inline Closeness<T> closeness(const T * a, const T * b, const ::std::size_t n, const T rtol, const T atol)
+{
+    // The lanes count in integers as wide as the elements, i.e. the vectorized kernels take chunks that they can't overflow.
+    constexpr ::std::size_t chunk = ::std::size_t(1) << 30;
+    Closeness<T> c{0, 0, n, 0};
+    for(::std::size_t offset = 0; offset < n; offset += chunk)
+    {
+        const ::std::size_t length = (n - offset < chunk) ? (n - offset) : chunk;
+        Closeness<T> part{0, 0, length, 0};
+        switch(isa())
+        {
+#if CPP_VERIFY_SIMD
+            case Isa::avx512: part = closeness_avx512(a + offset, b + offset, length, rtol, atol); break;
+            case Isa::avx2:   part = closeness_avx2  (a + offset, b + offset, length, rtol, atol); break;
+            case Isa::sse2:   part = closeness_sse2  (a + offset, b + offset, length, rtol, atol); break;
+#endif
+            default:          closeness_scalar(part, a + offset, b + offset, 0, length, rtol, atol); break;
+        }
+        if(part.max_absolute > c.max_absolute)
+            c.max_absolute = part.max_absolute;
+        if(part.worst_rank > c.worst_rank)
+            c.worst_rank = part.worst_rank, c.worst = offset + part.worst;
+        if(part.max_relative > c.max_relative)
+            c.max_relative = part.max_relative;
+        c.failures += part.failures;
+    }
+    return c;
+}
+
+/// The 128-bit hash of `n` bytes. The last, partial stripe is padded with zeros, and the length is part of the hash.
+inline Hash hash(const unsigned char * p, const ::std::size_t n)
+{
+    ::std::uint64_t acc[hash_lanes];
+    ::std::memcpy(acc, hash_keys.initial, sizeof(acc));
+
+    const ::std::size_t stripes = n / hash_stripe;
+    switch(isa())
+    {
+#if CPP_VERIFY_SIMD
+        case Isa::avx512: hash_stripes_avx512(acc, p, stripes); break;
+        case Isa::avx2:   hash_stripes_avx2  (acc, p, stripes); break;
+        case Isa::sse2:   hash_stripes_sse2  (acc, p, stripes); break;
+#endif
+        default:          hash_stripes_scalar(acc, p, stripes); break;
+    }
+    if(const ::std::size_t rest = n % hash_stripe)
+    {
+        unsigned char last[hash_stripe] = {};
+        ::std::memcpy(last, p + stripes * hash_stripe, rest);
+        hash_stripe_scalar(acc, last, hash_keys.stripe[stripes % hash_block]);
+    }
+
+    Hash h{n * hash_prime64, ~n * hash_prime32};
+    for(::std::size_t i = 0; i < hash_lanes; i += 2)
+    {
+        h.low += fold64(acc[i] ^ hash_keys.merge[0][i], acc[i + 1] ^ hash_keys.merge[0][i + 1]);
+        h.high += fold64(acc[i] ^ hash_keys.merge[1][i], acc[i + 1] ^ hash_keys.merge[1][i + 1]);
+    }
+    return Hash{avalanche(h.low), avalanche(h.high)};
+}
+
+struct Scan
+{
+    ::std::size_t first;    ///< Index of the first failure, or the amount of elements if none failed.
+    ::std::size_t failures; ///< Amount of failures.
+};
+
+/// Find the first failure as fast as possible; only then count all the failures.
+template<typename Comparison, typename T, typename Source>
+inline Scan scan(const T * a, const Source & b, const ::std::size_t n)
+{
+    const ::std::size_t first = find_first<Comparison>(a, b, n);
+    return Scan{first, (first < n) ? 1 + count_scalar<Comparison>(a, b, first + 1, n) : 0};
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,292 @@
+//////
+/// \file     verify-lanes.hpp
+/// \brief    Provide the verify_lanes() function, that checks one comparison for every lane of a SIMD vector at once.
+///
+/// \details  Like verify_all(), with the comparison operator as its second argument:
+///           ```
+///           __m256 sums = ...;
+///           std::cout << verify_lanes(sums, >=, 0.0f);
+///           ```
+///           will print something like:
+///           "verify_lanes(sums >= 0.0f) => verify_lanes([2]: -1 >= 0, [5]: -3 >= 0; 2 of 8 lanes fail (mask 0x24)) => false".
+///
+///           The vectors are GNU vectors (e.g. `__m128`, `__m256d`, or `int __attribute__((vector_size(32)))`),
+///           or `std::experimental::simd`s, where available. The right-hand side is either a vector of the same size,
+///           or a single value for all lanes. The lanes are those of the left-hand vector, and a right-hand vector is read likewise.
+///           The integer registers (`__m128i`, `__m256i`, `__m512i`) come in lanes of 64 bits, so narrower ones are
+///           chosen via `CppVerify::lanes<T>()`, e.g. `verify_lanes(CppVerify::lanes<std::int32_t>(counts), ==, expected)`.
+///
+///           All lanes are compared at once, and reduced via `movemask` (on x86, for the instruction sets the code is compiled for).
+///           That's all a passing check costs, so that it may stay inside hot kernels. The failing lanes are only located for printing.
+///
+///           With `CPP_VERIFY_DECOMPOSE=0`, only the code is kept alongside the boolean result.
+//////
+
+#ifndef CPP_VERIFY_LANES_HPP
+#define CPP_VERIFY_LANES_HPP
+
+#include "verify.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ios>
+#include <ostream>
+#include <type_traits>
+
+#if !defined(__GNUC__) && !defined(__clang__)
+    #error "verify_lanes() needs the vector extensions of GCC or Clang."
+#endif
+
+#if defined(__SSE2__)
+    #include <immintrin.h>
+#endif
+
+#if defined(__has_include)
+    #if __has_include(<experimental/simd>)
+        #include <experimental/simd>
+    #endif
+#endif
+
+#define verify_lanes(vector, comparison, operand) \
+    CPP_VERIFY__IGNORE_SUPERFLUOUS_WARNINGS( \
+        \
+        (CppVerify::each_lane(#vector " " #comparison " " #operand, (vector)) comparison (operand)) \
+        \
+    )
+
+namespace CppVerify {
+
+template<typename T, ::std::size_t Bytes> struct LaneVector
+{
+    typedef T type __attribute__((vector_size(Bytes)));
+};
+
+/// GNU vectors, i.e. types with the `vector_size` attribute: subscriptable, but neither class, array nor pointer.
+template<typename V, typename = void> struct is_gnu_vector : ::std::false_type { };
+template<typename V> struct is_gnu_vector<V, ::std::void_t<decltype(::std::declval<V &>()[0])>>
+    : ::std::integral_constant<bool, !::std::is_class<V>::value && !::std::is_array<V>::value && !::std::is_pointer<V>::value> { };
+
+template<typename V> struct is_simd : ::std::false_type { };
+#if defined(__cpp_lib_experimental_parallel_simd)
+template<typename T, typename Abi> struct is_simd<::std::experimental::simd<T, Abi>> : ::std::true_type { };
+#endif
+
+/// A GNU vector, read in lanes of `T` (see `lanes()`).
+template<typename T, typename V> struct LaneView
+{
+    const V & vector;
+};
+
+template<typename V> struct is_lane_view : ::std::false_type { };
+template<typename T, typename V> struct is_lane_view<LaneView<T, V>> : ::std::true_type { };
+
+/// The lanes of a GNU vector, of a `std::experimental::simd`, or of a `LaneView`.
+template<typename V, typename = void> struct lanes_of;
+template<typename V> struct lanes_of<V, typename ::std::enable_if<is_gnu_vector<V>::value>::type>
+{
+    using element_type = ::std::remove_cv_t<::std::remove_reference_t<decltype(::std::declval<V &>()[0])>>;
+    static constexpr ::std::size_t count = sizeof(V) / sizeof(element_type);
+};
+template<typename V> struct lanes_of<V, typename ::std::enable_if<is_simd<V>::value>::type>
+{
+    using element_type = typename V::value_type;
+    static constexpr ::std::size_t count = V::size();
+};
+template<typename T, typename V> struct lanes_of<LaneView<T, V>>
+{
+    using element_type = T;
+    static constexpr ::std::size_t count = sizeof(V) / sizeof(T);
+};
+
+/// The plain GNU vector, that the lanes of `V` are compared in.
+template<typename V> using lane_vector_t = typename LaneVector<typename lanes_of<V>::element_type, lanes_of<V>::count * sizeof(typename lanes_of<V>::element_type)>::type;
+
+/// Read the integer register (or any other GNU vector) `v` in lanes of `T`, e.g. `lanes<std::int32_t>(_mm_set1_epi32(1))`.
+/// (The vector is referred to, rather than copied: Returning wide vectors by value would depend on the instruction set.)
+template<typename T, typename V> constexpr LaneView<T, V> lanes(const V & v)
+{
+    static_assert(is_gnu_vector<V>::value && sizeof(V) % sizeof(T) == 0, "lanes<T>() reads a GNU vector in lanes of T.");
+    return LaneView<T, V>{v};
+}
+
+/// Copy the lanes of a vector into `v` (or, for a single value, broadcast it into all lanes).
+template<typename V, typename U> void load_lanes(V & v, const U & operand)
+{
+    using T = ::std::remove_cv_t<::std::remove_reference_t<decltype(v[0])>>;
+    if constexpr(is_gnu_vector<U>::value)
+    {
+        static_assert(sizeof(U) == sizeof(V), "verify_lanes() compares vectors of the same size.");
+        ::std::memcpy(&v, &operand, sizeof(V));
+    }
+    else if constexpr(is_lane_view<U>::value)
+    {
+        static_assert(sizeof(operand.vector) == sizeof(V), "verify_lanes() compares vectors of the same size.");
+        ::std::memcpy(&v, &operand.vector, sizeof(V));
+    }
+#if defined(__cpp_lib_experimental_parallel_simd)
+    else if constexpr(is_simd<U>::value)
+    {
+        static_assert(sizeof(typename U::value_type) * U::size() == sizeof(V), "verify_lanes() compares vectors of the same size.");
+        typename U::value_type elements[U::size()];
+        operand.copy_to(elements, ::std::experimental::element_aligned);
+        ::std::memcpy(&v, elements, sizeof(V));
+    }
+#endif
+    else
+        v = V{} + static_cast<T>(operand);
+}
+
+/// Whether all lanes of a mask (i.e. of a lane-wise comparison) are set: one `movemask` per register on x86.
+template<typename Mask> bool all_lanes_set(const Mask & mask)
+{
+#if defined(__AVX2__)
+    if constexpr(sizeof(Mask) % 32 == 0)
+    {
+        ::std::uint32_t all = ~::std::uint32_t(0);
+        for(::std::size_t i = 0; i < sizeof(Mask); i += 32)
+        {
+            __m256i part;
+            ::std::memcpy(&part, reinterpret_cast<const char *>(&mask) + i, 32);
+            all &= static_cast<::std::uint32_t>(_mm256_movemask_epi8(part));
+        }
+        return (all == ~::std::uint32_t(0));
+    }
+    else
+#endif
+#if defined(__SSE2__)
+    if constexpr(sizeof(Mask) % 16 == 0)
+    {
+        int all = 0xFFFF;
+        for(::std::size_t i = 0; i < sizeof(Mask); i += 16)
+        {
+            __m128i part;
+            ::std::memcpy(&part, reinterpret_cast<const char *>(&mask) + i, 16);
+            all &= _mm_movemask_epi8(part);
+        }
+        return (all == 0xFFFF);
+    }
+    else
+#endif
+    {
+        constexpr ::std::size_t lanes = sizeof(Mask) / sizeof(mask[0]);
+        bool all = true;
+        for(::std::size_t i = 0; i < lanes; ++i)
+            all &= (mask[i] != 0);
+        return all;
+    }
+}
+
+/// One bit per lane of a mask, set where the lane is set.
+template<typename Mask> ::std::uint64_t lane_bits(const Mask & mask)
+{
+    constexpr ::std::size_t lanes = sizeof(Mask) / sizeof(mask[0]);
+    static_assert(lanes <= 64, "verify_lanes() compares vectors of up to 64 lanes.");
+    ::std::uint64_t bits = 0;
+    for(::std::size_t i = 0; i < lanes; ++i)
+        bits |= static_cast<::std::uint64_t>(mask[i] != 0) << i;
+    return bits;
+}
+
+/// The lanes where the comparison holds, one bit each (only needed for printing).
+template<typename Comparison, typename V> ::std::uint64_t passing_lanes(const V & a, const V & b)
+{
+    if constexpr(::std::is_same<Comparison, EQ>::value) return lane_bits(a == b);
+    if constexpr(::std::is_same<Comparison, NE>::value) return lane_bits(a != b);
+    if constexpr(::std::is_same<Comparison, LE>::value) return lane_bits(a <= b);
+    if constexpr(::std::is_same<Comparison, GE>::value) return lane_bits(a >= b);
+    if constexpr(::std::is_same<Comparison, LT>::value) return lane_bits(a <  b);
+    if constexpr(::std::is_same<Comparison, GT>::value) return lane_bits(a >  b);
+}
+
+/// Whether the comparison holds in all lanes, i.e. just one vector compare and one `movemask` per register.
+template<typename Comparison, typename V> bool all_lanes_pass(const V & a, const V & b)
+{
+    if constexpr(::std::is_same<Comparison, EQ>::value) return all_lanes_set(a == b);
+    if constexpr(::std::is_same<Comparison, NE>::value) return all_lanes_set(a != b);
+    if constexpr(::std::is_same<Comparison, LE>::value) return all_lanes_set(a <= b);
+    if constexpr(::std::is_same<Comparison, GE>::value) return all_lanes_set(a >= b);
+    if constexpr(::std::is_same<Comparison, LT>::value) return all_lanes_set(a <  b);
+    if constexpr(::std::is_same<Comparison, GT>::value) return all_lanes_set(a >  b);
+}
+
+
+#if CPP_VERIFY_DECOMPOSE
+
+template<typename V, typename Comparison> struct LanesExpression
+{
+    static constexpr const char * macro = "verify_lanes";
+    static constexpr ::std::size_t lanes = sizeof(V) / sizeof(V{}[0]);
+
+    V op1;
+    V op2;
+    bool pass;
+
+    constexpr bool evaluate() const { return pass; }
+
+    friend ::std::ostream & operator<<(::std::ostream & os, const LanesExpression & this_)
+    {
+        if(this_.pass)
+            return os << lanes << " of " << lanes << " lanes pass";
+
+        // Only the first few failing lanes are listed, but all of them are counted (and shown in the mask).
+        const ::std::uint64_t failing = ~passing_lanes<Comparison>(this_.op1, this_.op2) & ((lanes == 64) ? ~::std::uint64_t(0) : ((::std::uint64_t(1) << lanes) - 1));
+        ::std::size_t failures = 0;
+        for(::std::size_t i = 0; i < lanes; ++i)
+        {
+            if(((failing >> i) & 1) == 0)
+                continue;
+            if(failures < CPP_VERIFY_DIFF_EDITS)
+                os << (failures > 0 ? ", " : "") << '[' << i << "]: " << +this_.op1[i] << Comparison() << +this_.op2[i];
+            else if(failures == CPP_VERIFY_DIFF_EDITS)
+                os << ", ...";
+            ++failures;
+        }
+        return os << "; " << failures << " of " << lanes << " lanes fail (mask 0x" << ::std::hex << failing << ::std::dec << ')';
+    }
+};
+
+#endif // CPP_VERIFY_DECOMPOSE
+
+
+/// Compare all lanes of a vector to those of another vector (or to a single value) at once.
+template<typename Comparison, typename L, typename R>
+auto check_lanes(const char * code, const L & op1, const R & op2)
+{
+    lane_vector_t<L> a;
+    lane_vector_t<L> b;
+    load_lanes(a, op1);
+    load_lanes(b, op2);
+    const bool pass = all_lanes_pass<Comparison>(a, b);
+
+#if CPP_VERIFY_DECOMPOSE
+    return make_decomposition(code, LanesExpression<lane_vector_t<L>, Comparison>{a, b, pass});
+#else
+    return Condition(code, pass);
+#endif
+}
+
+
+/// Capture the vector and offer the comparison operators, that capture the right-hand side.
+template<typename L> struct EachLane
+{
+    const char * const code;
+    const L & vector;
+
+    template<typename R> auto operator==(const R & op2) const { return check_lanes<EQ>(code, vector, op2); }
+    template<typename R> auto operator!=(const R & op2) const { return check_lanes<NE>(code, vector, op2); }
+    template<typename R> auto operator<=(const R & op2) const { return check_lanes<LE>(code, vector, op2); }
+    template<typename R> auto operator>=(const R & op2) const { return check_lanes<GE>(code, vector, op2); }
+    template<typename R> auto operator< (const R & op2) const { return check_lanes<LT>(code, vector, op2); }
+    template<typename R> auto operator> (const R & op2) const { return check_lanes<GT>(code, vector, op2); }
+};
+
+template<typename L> constexpr EachLane<L> each_lane(const char * code, const L & vector)
+{
+    static_assert(is_gnu_vector<L>::value || is_simd<L>::value || is_lane_view<L>::value, "verify_lanes() checks GNU vectors or std::experimental::simd.");
+    return EachLane<L>{code, vector};
+}
+
+}
+
+#endif
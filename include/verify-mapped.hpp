@@ -0,0 +1,133 @@
+//////
+/// \file     verify-mapped.hpp
+/// \brief    Provide `CppVerify::MappedFile`, a file mapped read-only into memory, for checks over large files.
+///
+/// \details  Where POSIX `mmap()` is available, the file is mapped (and its pages come straight from the page cache),
+///           i.e. nothing is copied or allocated. Elsewhere, or with `CPP_VERIFY_MMAP=0`, the file is read into a buffer instead.
+//////
+
+#ifndef CPP_VERIFY_MAPPED_HPP
+#define CPP_VERIFY_MAPPED_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <fstream>
+#include <vector>
+
+#ifndef CPP_VERIFY_MMAP
+    #if defined(__unix__) || defined(__APPLE__)
+        #define CPP_VERIFY_MMAP 1
+    #else
+        #define CPP_VERIFY_MMAP 0
+    #endif
+#endif
+
+#if CPP_VERIFY_MMAP
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#else
+    #include <filesystem>
+    #include <system_error>
+#endif
+
+namespace CppVerify {
+
+/// A file, mapped read-only into memory for its lifetime. If it can't be, it is empty, and `error()` tells why.
+/// Only regular files are mapped: Others (like FIFOs, devices or files in /proc) have no size to map, and are an error (EINVAL, or EISDIR).
+class MappedFile
+{
+public:
+    explicit MappedFile(const char * path)
+    {
+#if CPP_VERIFY_MMAP
+        // Opening doesn't wait for a writer, if it's a FIFO (which is rejected right away anyway).
+        const int file = ::open(path, O_RDONLY | O_CLOEXEC | O_NONBLOCK);
+        if(file < 0)
+        {
+            error_ = errno;
+            return;
+        }
+        struct stat status;
+        if(::fstat(file, &status) != 0)
+            error_ = errno;
+        else if(!S_ISREG(status.st_mode))
+            error_ = S_ISDIR(status.st_mode) ? EISDIR : EINVAL;
+        else if(status.st_size > 0)
+        {
+            void * const mapped = ::mmap(nullptr, static_cast<::std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+            if(mapped == MAP_FAILED)
+                error_ = errno;
+            else
+            {
+                data_ = static_cast<const unsigned char *>(mapped);
+                size_ = static_cast<::std::size_t>(status.st_size);
+                // The checks read front to back, so the kernel may read ahead (and drop pages behind).
+                ::madvise(mapped, size_, MADV_SEQUENTIAL);
+            }
+        }
+        ::close(file);
+#else
+        // The size comes from the file system: a stream's end is meaningless for e.g. a directory (where it may be -1, or 2^63 - 1).
+        ::std::error_code failure;
+        const ::std::filesystem::file_status status = ::std::filesystem::status(path, failure);
+        const auto size = ::std::filesystem::is_regular_file(status) ? ::std::filesystem::file_size(path, failure) : 0;
+        if(failure)
+        {
+            const ::std::error_condition condition = failure.default_error_condition();
+            error_ = (condition.category() == ::std::generic_category()) ? condition.value() : EIO;
+            return;
+        }
+        if(!::std::filesystem::is_regular_file(status))
+        {
+            error_ = ::std::filesystem::is_directory(status) ? EISDIR : EINVAL;
+            return;
+        }
+        ::std::ifstream file(path, ::std::ios::binary);
+        if(!file)
+        {
+            error_ = ENOENT;
+            return;
+        }
+        buffer_.resize(static_cast<::std::size_t>(size));
+        if(!file.read(reinterpret_cast<char *>(buffer_.data()), static_cast<::std::streamsize>(buffer_.size())))
+        {
+            error_ = EIO;
+            buffer_.clear();
+        }
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile & operator=(const MappedFile &) = delete;
+
+    ~MappedFile()
+    {
+#if CPP_VERIFY_MMAP
+        if(data_)
+            ::munmap(const_cast<unsigned char *>(data_), size_);
+#endif
+    }
+
+    const unsigned char * data() const { return data_; }
+    ::std::size_t size() const { return size_; }
+
+    /// The `errno` of the failure to map the file, or 0.
+    int error() const { return error_; }
+    explicit operator bool() const { return error_ == 0; }
+
+private:
+    const unsigned char * data_ = nullptr;
+    ::std::size_t size_ = 0;
+    int error_ = 0;
+#if !CPP_VERIFY_MMAP
+    ::std::vector<unsigned char> buffer_;
+#endif
+};
+
+}
+
+#endif
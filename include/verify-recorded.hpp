@@ -0,0 +1,185 @@
+//////
+/// \file     verify-recorded.hpp
+/// \brief    Provide `CppVerify::recorded()`, that lets verify() compare single-pass input ranges, and still print them.
+///
+/// \details  Comparing an input range (e.g. `std::istream_iterator`s, a generator, or `std::views::istream`) consumes it,
+///           so it can neither be printed afterwards, nor be compared without copying it first.
+///           `recorded(first, last)` (or `recorded(range)`) records the last `CPP_VERIFY_RANGE_ELEMENTS` elements it is compared by
+///           into a buffer of its own, while the comparison reads them. On failure, that's the context of the first difference:
+///           ```
+///           std::istringstream in("1 2 3 4 5 6 7 8 9 10 99 12");
+///           std::cout << verify(recorded(std::istream_iterator<int>(in), {}) == expected);
+///           ```
+///           will print something like:
+///           ```
+///           verify(recorded(std::istream_iterator<int>(in), {}) == expected) => verify(11 elements read == 12 elements, first difference at [10]: 99 vs. 11
+///             read [3..10]: {..., 4, 5, 6, 7, 8, 9, 10, 99}
+///           ) => false
+///           ```
+///           The comparison reads the input exactly once, and stops at the first difference. The buffer is part of the recorder,
+///           i.e. nothing is allocated (beyond what copying the elements takes).
+///           The right-hand side is any (multi-pass) range, e.g. a container. `verify(recorded(...) != expected)` works, too.
+///
+///           Like any other operand, a temporary recorder is gone after the full expression,
+///           so either name it (`auto numbers = recorded(...); verify(numbers == expected)`), or use verify_owned().
+//////
+
+#ifndef CPP_VERIFY_RECORDED_HPP
+#define CPP_VERIFY_RECORDED_HPP
+
+#include "verify.hpp"
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+namespace CppVerify {
+
+/// An input range, that records the last `N` elements it is compared by, and where the comparison stopped.
+/// The recording is done by the (const) comparison, so the recorder's state is `mutable`. It compares once; later comparisons repeat its result.
+template<typename I, typename S = I, ::std::size_t N = CPP_VERIFY_RANGE_ELEMENTS> class Recorded
+{
+public:
+    using value_type = typename ::std::remove_cv<typename ::std::remove_reference<decltype(*::std::declval<I &>())>::type>::type;
+
+    static constexpr ::std::size_t capacity = N;
+    static_assert(N > 0, "recorded() keeps at least one element");
+
+    Recorded(I first, S last) : first(::std::move(first)), last(::std::move(last)) { }
+
+    /// Compare with the (multi-pass) range `other`, reading this one up to the first difference, or one element beyond the end of `other`.
+    template<typename R> bool equals(const R & other) const
+    {
+        if(result)
+            return *result;
+
+        auto j = ::std::begin(other);
+        const auto end = ::std::end(other);
+        for(; first != last && j != end; ++first, ++j)
+        {
+            if(!(record(*first) == *j))
+                return *(result = false);
+        }
+        if(first != last)
+        {
+            record(*first);
+            return *(result = false);
+        }
+        exhausted = true;
+        return *(result = (j == end));
+    }
+
+    /// Amount of elements read by the comparison.
+    ::std::size_t size() const { return count; }
+
+    /// Whether the comparison read all elements, i.e. up to the end.
+    bool at_end() const { return exhausted; }
+
+    /// Index of the first recorded element (earlier ones were overwritten).
+    ::std::size_t start() const { return (count > N) ? (count - N) : 0; }
+
+    /// The element at `index`, which must be in `[start(), size())`.
+    const value_type & operator[](const ::std::size_t index) const { return *ring[index % N]; }
+
+    friend ::std::ostream & operator<<(::std::ostream & os, const Recorded & this_)
+    {
+        os << '{' << ((this_.start() > 0) ? "..., " : "");
+        for(::std::size_t i = this_.start(); i < this_.count; ++i)
+        {
+            os << ((i > this_.start()) ? ", " : "");
+#if CPP_VERIFY_DECOMPOSE
+            print(os, this_[i]);
+#else
+            os << this_[i];
+#endif
+        }
+        return os << '}';
+    }
+
+private:
+    const value_type & record(const value_type & x) const
+    {
+        ::std::optional<value_type> & slot = ring[count++ % N];
+        slot = x;
+        return *slot;
+    }
+
+    mutable I first;
+    S last;
+    mutable ::std::array<::std::optional<value_type>, N> ring;
+    mutable ::std::size_t count = 0;
+    mutable bool exhausted = false;
+    mutable ::std::optional<bool> result;
+};
+
+template<::std::size_t N = CPP_VERIFY_RANGE_ELEMENTS, typename I, typename S> auto recorded(I first, S last)
+{
+    return Recorded<I, S, N>(::std::move(first), ::std::move(last));
+}
+
+/// The range has to outlive the recorder, which keeps just its iterators.
+template<::std::size_t N = CPP_VERIFY_RANGE_ELEMENTS, typename R> auto recorded(R & range)
+{
+    return recorded<N>(::std::begin(range), ::std::end(range));
+}
+
+template<typename I, typename S, ::std::size_t N, typename R, typename = typename ::std::enable_if<is_range<R>::value>::type>
+bool operator==(const Recorded<I, S, N> & op1, const R & op2) { return op1.equals(op2); }
+
+template<typename I, typename S, ::std::size_t N, typename R, typename = typename ::std::enable_if<is_range<R>::value>::type>
+bool operator!=(const Recorded<I, S, N> & op1, const R & op2) { return !op1.equals(op2); }
+
+
+#if CPP_VERIFY_DECOMPOSE
+
+// Equality prints all elements, if the input was read up to its end, and both sides are short:
+// ```
+// {1, 2, 3} == {1, 2}
+// ```
+// Otherwise, where the comparison stopped, and the recorded elements up to there:
+// ```
+// 11 elements read == 12 elements, first difference at [10]: 99 vs. 11
+//   read [3..10]: {..., 4, 5, 6, 7, 8, 9, 10, 99}
+// ```
+template<typename I, typename S, ::std::size_t N, typename Comparison, typename R, typename = typename ::std::enable_if<
+    ::std::is_same<Comparison, EQ>::value || ::std::is_same<Comparison, NE>::value>::type>
+void explain(::std::ostream & os, const Recorded<I, S, N> & op1, const Comparison comparison, const R & op2, Rank<7>)
+{
+    const auto m = static_cast<::std::size_t>(::std::distance(::std::begin(op2), ::std::end(op2)));
+    const ::std::size_t n = op1.size();
+    if(op1.at_end() && n <= N && m <= N)
+        return explain(os, op1, comparison, op2, Rank<0>());
+
+    os << n << " elements read" << comparison << m << " elements, ";
+    // The comparison stopped at the difference, if any. That's the last element read, or the end of the input.
+    const bool equal = op1.at_end() && (n == m);
+    if(equal)
+    {
+        os << "no difference";
+        return;
+    }
+    const ::std::size_t first = op1.at_end() ? n : n - 1;
+    os << "first difference at [" << first << "]: ";
+    if(first < n)
+        print(os, op1[first]);
+    else
+        os << "(end)";
+    os << " vs. ";
+    if(first < m)
+        print(os, *::std::next(::std::begin(op2), static_cast<::std::ptrdiff_t>(first)));
+    else
+        os << "(end)";
+    os << '\n';
+    if(n > 0)
+        os << "  read [" << op1.start() << ".." << n - 1 << "]: " << op1 << '\n';
+}
+
+#endif // CPP_VERIFY_DECOMPOSE
+
+}
+
+#endif
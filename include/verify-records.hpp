@@ -0,0 +1,340 @@
+//////
+/// \file     verify-records.hpp
+/// \brief    Provide the verify_records() function, that checks every record of a (large) file of fixed-size binary records.
+///
+/// \details  The checks are comparisons of fields, built from member pointers and the comparison tags of verify():
+///           ```
+///           struct Order { std::int64_t id; double price; std::int32_t qty; std::int32_t limit; };
+///           using CppVerify::field;
+///           const auto price = field(&Order::price, "price");
+///           const auto qty = field(&Order::qty, "qty");
+///           const auto limit = field(&Order::limit, "limit");
+///           std::cout << verify_records("orders.bin", price > 0.0, qty <= limit);
+///           ```
+///           will print something like:
+///           ```
+///           verify_records("orders.bin", ...) => verify_records(2 of 1000000 records failed:
+///             [17] verify(price > 0) => verify(-1.5 > 0) => false
+///             [4711] verify(qty <= limit) => verify(1200 <= 1000) => false
+///           ) => false
+///           ```
+///           The file is mapped (see `MappedFile`), or the records are given as a pointer and a size in bytes instead.
+///           Either way, they are split into chunks of `CPP_VERIFY_RECORD_CHUNK` records, which are checked in parallel
+///           by `CppVerify::record_threads()` threads (as many as the hardware has, by default). Each record is copied out of the file,
+///           so the records needn't be aligned. The record type must be trivially copyable (but needn't be default-constructible).
+///           If a check throws, the other threads stop, and the exception is rethrown by verify_records(), once all threads are joined.
+///
+///           All failures are counted, but only the first `CPP_VERIFY_RECORD_FAILURES` (8 by default) are kept, with their index,
+///           and with the failing checks rendered like verify() does. Thus, the memory used doesn't grow with the file
+///           (nor with the amount of failures). Once as many failures are kept, later chunks aren't rendered anymore.
+///
+///           With `CPP_VERIFY_DECOMPOSE=0`, the records are still checked (in parallel), but only the code is kept alongside the boolean result.
+//////
+
+#ifndef CPP_VERIFY_RECORDS_HPP
+#define CPP_VERIFY_RECORDS_HPP
+
+#include "verify.hpp"
+#include "verify-mapped.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifndef CPP_VERIFY_RECORD_CHUNK
+    #define CPP_VERIFY_RECORD_CHUNK (::std::size_t(1) << 16)
+#endif
+
+#ifndef CPP_VERIFY_RECORD_FAILURES
+    #define CPP_VERIFY_RECORD_FAILURES 8
+#endif
+
+#define verify_records(...) (CppVerify::check_records(#__VA_ARGS__, __VA_ARGS__))
+
+namespace CppVerify {
+
+/// The amount of threads that verify_records() uses (at most): detected once, but may be changed at run-time,
+/// even while other threads check records (which then use either the old or the new amount).
+inline ::std::atomic<unsigned> & record_threads()
+{
+    static ::std::atomic<unsigned> threads{(::std::thread::hardware_concurrency() > 0) ? ::std::thread::hardware_concurrency() : 1};
+    return threads;
+}
+
+
+template<typename Record, typename T> struct Field;
+
+/// The right-hand side of a check: a value, as it is ...
+template<typename Record, typename U> struct Operand
+{
+    using type = U;
+
+    static const U & of(const Record &, const U & value) { return value; }
+    static void code(::std::ostream & os, const U & value) { print(os, value); }
+};
+
+/// ... or another field of the same record, by its name.
+template<typename Record, typename T> struct Operand<Record, Field<Record, T>>
+{
+    using type = T;
+
+    static const T & of(const Record & record, const Field<Record, T> & other) { return record.*(other.member); }
+    static void code(::std::ostream & os, const Field<Record, T> & other) { os << other.name; }
+};
+
+/// A comparison of the field `member` of a record with `value` (or with another field, e.g. `qty <= limit`).
+template<typename Record, typename T, typename Comparison, typename U> struct FieldCheck
+{
+    using record_type = Record;
+
+    T Record::* member;
+    const char * name;
+    U value;
+
+    bool operator()(const Record & record) const { return Comparison::evaluate(record.*member, Operand<Record, U>::of(record, value)); }
+
+#if CPP_VERIFY_DECOMPOSE
+    /// Print the check of `record` like verify() does, with the field's name and the value as code, e.g. "verify(price > 0) => verify(-1 > 0) => false".
+    void render(::std::ostream & os, const Record & record) const
+    {
+        ::std::stringstream code;
+        code << name << Comparison();
+        Operand<Record, U>::code(code, value);
+        const ::std::string text = code.str();
+        os << make_decomposition(text.c_str(), BinaryExpression<T, Comparison, typename Operand<Record, U>::type>(record.*member, Operand<Record, U>::of(record, value)));
+    }
+#endif
+};
+
+template<typename T> struct is_field_check : ::std::false_type { };
+template<typename Record, typename T, typename Comparison, typename U> struct is_field_check<FieldCheck<Record, T, Comparison, U>> : ::std::true_type { };
+
+/// A field of a record, to be compared with a value, e.g. `field(&Order::price, "price") > 0`, or with another field of the same record.
+template<typename Record, typename T> struct Field
+{
+    T Record::* member;
+    const char * name;
+
+    template<typename U> constexpr FieldCheck<Record, T, EQ, U> operator==(const U & value) const { return {member, name, value}; }
+    template<typename U> constexpr FieldCheck<Record, T, NE, U> operator!=(const U & value) const { return {member, name, value}; }
+    template<typename U> constexpr FieldCheck<Record, T, LE, U> operator<=(const U & value) const { return {member, name, value}; }
+    template<typename U> constexpr FieldCheck<Record, T, GE, U> operator>=(const U & value) const { return {member, name, value}; }
+    template<typename U> constexpr FieldCheck<Record, T, LT, U> operator<(const U & value) const { return {member, name, value}; }
+    template<typename U> constexpr FieldCheck<Record, T, GT, U> operator>(const U & value) const { return {member, name, value}; }
+};
+
+template<typename Record, typename T> constexpr Field<Record, T> field(T Record::* member, const char * name) { return {member, name}; }
+
+
+/// A failing record, with its failing checks rendered.
+struct RecordFailure
+{
+    ::std::size_t index;
+    ::std::string checks;
+};
+
+/// The outcome of checking all records.
+struct RecordScan
+{
+    ::std::size_t records = 0;              ///< Amount of records checked.
+    ::std::size_t failures = 0;             ///< Amount of records that failed any check.
+    ::std::vector<RecordFailure> first;     ///< The first `CPP_VERIFY_RECORD_FAILURES` failing records, in the order of the file.
+};
+
+/// Check all `records` at `data`, in chunks, in parallel.
+template<typename Record, typename... Checks>
+RecordScan scan_records(const unsigned char * data, const ::std::size_t records, const Checks &... checks)
+{
+    static_assert(::std::is_trivially_copyable<Record>::value, "verify_records() copies the records out of the file, byte by byte.");
+
+    // The failure of any thread stops the others, and is rethrown by the caller, once they are all joined.
+    ::std::exception_ptr exception;
+
+    constexpr ::std::size_t kept = CPP_VERIFY_RECORD_FAILURES;
+    const ::std::size_t chunk = CPP_VERIFY_RECORD_CHUNK;
+    const ::std::size_t chunks = records / chunk + (records % chunk != 0);
+
+    RecordScan scan;
+    scan.records = records;
+    ::std::atomic<::std::size_t> next{0};
+    ::std::atomic<::std::size_t> failures{0};
+    ::std::atomic<::std::size_t> horizon{::std::numeric_limits<::std::size_t>::max()}; ///< Failures beyond aren't kept anymore.
+    ::std::mutex mutex;
+
+    const auto check = [&]() {
+        ::std::vector<RecordFailure> mine;
+        for(::std::size_t c = next++; c < chunks; c = next++)
+        {
+            const ::std::size_t begin = c * chunk;
+            const ::std::size_t end = (records - begin < chunk) ? records : begin + chunk;
+            ::std::size_t failed = 0;
+            for(::std::size_t i = begin; i < end; ++i)
+            {
+                alignas(Record) unsigned char bytes[sizeof(Record)];
+                ::std::memcpy(bytes, data + i * sizeof(Record), sizeof(Record));
+                const Record & record = *::std::launder(reinterpret_cast<const Record *>(bytes));
+                if((checks(record) && ...))
+                    continue;
+                ++failed;
+#if CPP_VERIFY_DECOMPOSE
+                if(mine.size() < kept && i < horizon.load(::std::memory_order_relaxed))
+                {
+                    ::std::stringstream rendered;
+                    const char * separator = "";
+                    ((checks(record) ? void() : (rendered << separator, checks.render(rendered, record), separator = "; ", void())), ...);
+                    mine.push_back(RecordFailure{i, rendered.str()});
+                }
+#endif
+            }
+            failures += failed;
+
+            if(!mine.empty())
+            {
+                // Merge the failures of the chunk, and keep the first ones of all chunks.
+                const ::std::lock_guard<::std::mutex> lock(mutex);
+                for(RecordFailure & failure : mine)
+                    scan.first.push_back(::std::move(failure));
+                mine.clear();
+                ::std::sort(scan.first.begin(), scan.first.end(), [](const RecordFailure & a, const RecordFailure & b) { return a.index < b.index; });
+                if(scan.first.size() >= kept)
+                {
+                    scan.first.resize(kept);
+                    horizon = scan.first.back().index;
+                }
+            }
+        }
+    };
+    const auto work = [&]() {
+        try
+        {
+            check();
+        }
+        catch(...)
+        {
+            next = chunks;
+            const ::std::lock_guard<::std::mutex> lock(mutex);
+            if(!exception)
+                exception = ::std::current_exception();
+        }
+    };
+
+    const ::std::size_t threads = ::std::min<::std::size_t>(::std::max(record_threads().load(), 1u), chunks);
+    ::std::vector<::std::thread> pool;
+    try
+    {
+        pool.reserve(threads);
+        for(::std::size_t t = 1; t < threads; ++t)
+            pool.emplace_back(work);
+    }
+    catch(...)
+    {
+        // Fewer threads (down to the calling one alone) check all records just as well.
+    }
+    work();
+    for(::std::thread & thread : pool)
+        thread.join();
+    if(exception)
+        ::std::rethrow_exception(exception);
+
+    scan.failures = failures;
+    return scan;
+}
+
+
+#if CPP_VERIFY_DECOMPOSE
+
+struct RecordsExpression
+{
+    static constexpr const char * macro = "verify_records";
+
+    ::std::size_t size;     ///< Size of a record.
+    ::std::size_t trailing; ///< Amount of bytes beyond the last whole record.
+    int error;              ///< The `errno` of mapping the file, or 0.
+    ::std::string path;     ///< The file, if it couldn't be mapped.
+    RecordScan scan;
+
+    bool evaluate() const { return (error == 0) && (trailing == 0) && (scan.failures == 0); }
+
+    friend ::std::ostream & operator<<(::std::ostream & os, const RecordsExpression & this_)
+    {
+        if(this_.error != 0)
+            return os << "file " << this_.path << " not readable (" << ::std::generic_category().message(this_.error) << ')';
+        if(this_.scan.failures == 0)
+            os << this_.scan.records << " records of " << this_.size << " bytes passed";
+        else
+            os << this_.scan.failures << " of " << this_.scan.records << " records failed";
+        if(this_.trailing != 0)
+            os << ", " << this_.trailing << " bytes left over";
+        if(this_.scan.failures == 0)
+            return os;
+
+        os << ":\n";
+        for(const RecordFailure & failure : this_.scan.first)
+            os << "  [" << failure.index << "] " << failure.checks << '\n';
+        if(this_.scan.failures > this_.scan.first.size())
+            os << "  ...\n";
+        return os;
+    }
+};
+
+#endif // CPP_VERIFY_DECOMPOSE
+
+
+template<typename... Checks> using record_of = typename ::std::common_type<typename Checks::record_type...>::type;
+
+template<typename... Checks>
+auto compare_records(const char * code, const void * data, const ::std::size_t n, const int error, const char * path, const Checks &... checks)
+{
+    using Record = record_of<Checks...>;
+    static_assert((::std::is_same<Record, typename Checks::record_type>::value && ...), "verify_records() checks fields of a single record type.");
+
+    const RecordScan scan = scan_records<Record>(static_cast<const unsigned char *>(data), n / sizeof(Record), checks...);
+    const ::std::size_t trailing = n % sizeof(Record);
+
+#if CPP_VERIFY_DECOMPOSE
+    RecordsExpression x{sizeof(Record), trailing, error, {}, ::std::move(scan)};
+    if(error != 0)
+        x.path = path;
+    return make_decomposition(code, ::std::move(x));
+#else
+    static_cast<void>(path);
+    return Condition(code, error == 0 && trailing == 0 && scan.failures == 0);
+#endif
+}
+
+/// Check the records in the file at `path`.
+template<typename P, typename... Checks, typename = typename ::std::enable_if<(sizeof...(Checks) > 0) && (is_field_check<Checks>::value && ...)>::type>
+auto check_records(const char * code, const P & path, const Checks &... checks)
+{
+    const char * file = nullptr;
+    if constexpr(::std::is_convertible<const P &, const char *>::value)
+        file = path;
+    else
+        file = path.c_str();
+    const MappedFile mapped(file);
+    return compare_records(code, mapped.data(), mapped.size(), mapped.error(), file, checks...);
+}
+
+/// Check the records in the `n` bytes at `data`.
+template<typename... Checks, typename = typename ::std::enable_if<(sizeof...(Checks) > 0) && (is_field_check<Checks>::value && ...)>::type>
+auto check_records(const char * code, const void * data, const ::std::size_t n, const Checks &... checks)
+{
+    return compare_records(code, data, n, 0, nullptr, checks...);
+}
+
+}
+
+#endif
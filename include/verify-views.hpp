@@ -0,0 +1,396 @@
+//////
+/// \file     verify-views.hpp
+/// \brief    Provide the verify_equal() function, that compares two multidimensional views (e.g. images or tensors) element by element.
+///
+/// \details  `verify_equal(a, b)` compares two views of equal extents, and `verify_equal(a, b, tolerance)` allows `|a - b| <= tolerance`.
+///           On failure, it reports the coordinates of the first mismatch, with the values around it:
+///           ```
+///           float pixels[3 * 4] = ..., expected[3 * 4] = ...;
+///           std::cout << verify_equal(CppVerify::row_major(pixels, 3, 4), CppVerify::row_major(expected, 3, 4));
+///           ```
+///           will print something like:
+///           ```
+///           verify_equal(CppVerify::row_major(pixels, 3, 4), CppVerify::row_major(expected, 3, 4)) => verify_equal((1, 2): 5 vs. 7; 1 of 12 elements differ
+///                  [1]  [2]  [3]
+///             [0]    2    3    4
+///             [1]    6  5/7    8
+///             [2]   10   11   12
+///           ) => false
+///           ```
+///           The neighbourhood spans the last two coordinates, and shows "left/right" where the elements differ.
+///           "First" refers to the memory order of the left-hand view.
+///
+///           The views are either `CppVerify::View`s (from `row_major()`, `column_major()`, or with arbitrary strides),
+///           or `std::mdspan`s with a strided layout, where available (C++23).
+///           Both are walked in the memory order of the left-hand view. If the right-hand view is laid out differently
+///           (e.g. row-major against column-major), the innermost two dimensions are walked in tiles of `CPP_VERIFY_VIEW_TILE`²
+///           elements instead, so that both views stay in the cache.
+///
+///           With `CPP_VERIFY_DECOMPOSE=0`, only the code is kept alongside the boolean result.
+//////
+
+#ifndef CPP_VERIFY_VIEWS_HPP
+#define CPP_VERIFY_VIEWS_HPP
+
+#include "verify.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iomanip>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#if defined(__cpp_lib_mdspan)
+    #include <mdspan>
+#endif
+
+#ifndef CPP_VERIFY_VIEW_TILE
+    #define CPP_VERIFY_VIEW_TILE 64
+#endif
+
+#define verify_equal(...) (CppVerify::check_views(#__VA_ARGS__, __VA_ARGS__))
+
+namespace CppVerify {
+
+/// A multidimensional view onto elements in memory, i.e. a minimal `std::mdspan` with a strided layout.
+template<typename T, ::std::size_t Rank> struct View
+{
+    static_assert(Rank > 0, "A view has at least one dimension.");
+
+    using element_type = T;
+    static constexpr ::std::size_t rank = Rank;
+
+    T * data;
+    ::std::array<::std::size_t, Rank> extents;
+    ::std::array<::std::ptrdiff_t, Rank> strides;   ///< In elements, per dimension.
+
+    constexpr ::std::ptrdiff_t offset(const ::std::array<::std::size_t, Rank> & index) const
+    {
+        ::std::ptrdiff_t offset = 0;
+        for(::std::size_t d = 0; d < Rank; ++d)
+            offset += static_cast<::std::ptrdiff_t>(index[d]) * strides[d];
+        return offset;
+    }
+
+    constexpr T & operator[](const ::std::array<::std::size_t, Rank> & index) const { return data[offset(index)]; }
+
+    constexpr ::std::size_t size() const
+    {
+        ::std::size_t size = 1;
+        for(const ::std::size_t extent : extents)
+            size *= extent;
+        return size;
+    }
+};
+
+/// A view with the last index varying fastest (like C arrays and `std::layout_right`).
+template<typename T, typename... Extents> constexpr View<T, sizeof...(Extents)> row_major(T * data, const Extents... extents)
+{
+    View<T, sizeof...(Extents)> view{data, {static_cast<::std::size_t>(extents)...}, {}};
+    ::std::ptrdiff_t stride = 1;
+    for(::std::size_t d = sizeof...(Extents); d-- > 0; stride *= static_cast<::std::ptrdiff_t>(view.extents[d]))
+        view.strides[d] = stride;
+    return view;
+}
+
+/// A view with the first index varying fastest (like Fortran arrays and `std::layout_left`).
+template<typename T, typename... Extents> constexpr View<T, sizeof...(Extents)> column_major(T * data, const Extents... extents)
+{
+    View<T, sizeof...(Extents)> view{data, {static_cast<::std::size_t>(extents)...}, {}};
+    ::std::ptrdiff_t stride = 1;
+    for(::std::size_t d = 0; d < sizeof...(Extents); stride *= static_cast<::std::ptrdiff_t>(view.extents[d++]))
+        view.strides[d] = stride;
+    return view;
+}
+
+template<typename T, ::std::size_t Rank> constexpr const View<T, Rank> & to_view(const View<T, Rank> & view) { return view; }
+
+#if defined(__cpp_lib_mdspan)
+
+template<typename T, typename Extents, typename Layout, typename Accessor>
+View<T, Extents::rank()> to_view(const ::std::mdspan<T, Extents, Layout, Accessor> & m)
+{
+    static_assert(::std::is_same<Accessor, ::std::default_accessor<T>>::value, "verify_equal() reads the elements of a std::mdspan directly.");
+    static_assert(Layout::template mapping<Extents>::is_always_strided(), "verify_equal() takes a std::mdspan with a strided layout.");
+
+    View<T, Extents::rank()> view{m.data_handle(), {}, {}};
+    for(::std::size_t d = 0; d < Extents::rank(); ++d)
+    {
+        view.extents[d] = static_cast<::std::size_t>(m.extent(d));
+        view.strides[d] = static_cast<::std::ptrdiff_t>(m.stride(d));
+    }
+    return view;
+}
+
+#endif
+
+
+//////
+// == Comparisons ==
+
+struct Exactly
+{
+    template<typename T, typename U> constexpr bool operator()(const T & x, const U & y) const { return (x == y); }
+
+    friend ::std::ostream & operator<<(::std::ostream & os, const Exactly) { return os; }
+};
+
+/// `|x - y| <= margin`, without wrapping around for unsigned elements. NaN is never within any margin.
+template<typename M> struct Tolerance
+{
+    M margin;
+
+    template<typename T, typename U> constexpr bool operator()(const T & x, const U & y) const { return (((x > y) ? (x - y) : (y - x)) <= margin); }
+
+    friend ::std::ostream & operator<<(::std::ostream & os, const Tolerance & this_) { return os << " within " << this_.margin; }
+};
+
+
+//////
+// == Traversal ==
+
+template<::std::size_t Rank> struct ViewScan
+{
+    ::std::size_t mismatches;               ///< Amount of differing elements.
+    ::std::array<::std::size_t, Rank> first;///< Coordinates of the first mismatch (in the memory order of the left-hand view).
+};
+
+/// Compare all elements of two views of equal extents, walking the left-hand one in memory order, or in tiles if the right-hand one is transposed.
+template<typename T, typename U, ::std::size_t Rank, typename Equal>
+ViewScan<Rank> scan_views(const View<T, Rank> & a, const View<U, Rank> & b, const Equal & equal)
+{
+    ViewScan<Rank> scan{0, {}};
+    if(a.size() == 0)
+        return scan;
+
+    const auto magnitude = [](const ::std::ptrdiff_t stride) { return (stride < 0) ? -stride : stride; };
+
+    // The dimensions from outermost to innermost, as laid out in the left-hand view.
+    ::std::array<::std::size_t, Rank> order;
+    for(::std::size_t d = 0; d < Rank; ++d)
+        order[d] = d;
+    ::std::stable_sort(order.begin(), order.end(), [&](::std::size_t x, ::std::size_t y) { return magnitude(a.strides[x]) > magnitude(a.strides[y]); });
+
+    // The innermost dimension `p` is walked in runs; the next one `q` either one by one,
+    // or in tiles along with `p`, if the right-hand view is innermost along `q` instead.
+    const ::std::size_t p = order[Rank - 1];
+    const ::std::size_t q = (Rank > 1) ? order[Rank - 2] : p;
+    const bool transposed = (Rank > 1) && magnitude(b.strides[q]) < magnitude(b.strides[p]);
+    const ::std::size_t extent_p = a.extents[p];
+    const ::std::size_t extent_q = (Rank > 1) ? a.extents[q] : 1;
+    const ::std::size_t tile_p = transposed ? CPP_VERIFY_VIEW_TILE : extent_p;
+    const ::std::size_t tile_q = transposed ? CPP_VERIFY_VIEW_TILE : 1;
+    const ::std::ptrdiff_t stride_a = a.strides[p];
+    const ::std::ptrdiff_t stride_b = b.strides[p];
+
+    ::std::ptrdiff_t first_offset = 0;
+    ::std::array<::std::size_t, Rank> index{};
+    for(;;)
+    {
+        for(::std::size_t q0 = 0; q0 < extent_q; q0 += tile_q)
+        for(::std::size_t p0 = 0; p0 < extent_p; p0 += tile_p)
+        {
+            const ::std::size_t q1 = (extent_q - q0 < tile_q) ? extent_q : q0 + tile_q;
+            const ::std::size_t p1 = (extent_p - p0 < tile_p) ? extent_p : p0 + tile_p;
+            for(::std::size_t iq = q0; iq < q1; ++iq)
+            {
+                if(Rank > 1)
+                    index[q] = iq;
+                index[p] = 0;
+                const T * const row_a = a.data + a.offset(index);
+                const U * const row_b = b.data + b.offset(index);
+
+                // Count without branches first, so that passing runs are compared at full speed.
+                ::std::size_t mismatches = 0;
+                for(::std::size_t ip = p0; ip < p1; ++ip)
+                    mismatches += !equal(row_a[static_cast<::std::ptrdiff_t>(ip) * stride_a], row_b[static_cast<::std::ptrdiff_t>(ip) * stride_b]);
+                if(mismatches == 0)
+                    continue;
+
+                for(::std::size_t ip = p0; ip < p1; ++ip)
+                {
+                    if(equal(row_a[static_cast<::std::ptrdiff_t>(ip) * stride_a], row_b[static_cast<::std::ptrdiff_t>(ip) * stride_b]))
+                        continue;
+                    index[p] = ip;
+                    const ::std::ptrdiff_t offset = a.offset(index);
+                    if(scan.mismatches == 0 || offset < first_offset)
+                        first_offset = offset, scan.first = index;
+                    ++scan.mismatches;
+                }
+            }
+        }
+
+        // Advance the outer dimensions like an odometer, the innermost of them first.
+        ::std::size_t k = (Rank > 1) ? Rank - 2 : 0;
+        for(; k-- > 0; )
+        {
+            const ::std::size_t d = order[k];
+            if(++index[d] < a.extents[d])
+                break;
+            index[d] = 0;
+        }
+        if(k == static_cast<::std::size_t>(-1))
+            return scan;
+    }
+}
+
+
+#if CPP_VERIFY_DECOMPOSE
+
+template<typename T, typename U, ::std::size_t Rank, typename Equal> struct ViewExpression
+{
+    static constexpr const char * macro = "verify_equal";
+    static constexpr ::std::size_t radius = 1;              ///< The neighbourhood spans the first mismatch ± 1 in the last two coordinates.
+    static constexpr ::std::size_t span = 2 * radius + 1;
+
+    ::std::array<::std::size_t, Rank> extents;
+    ::std::array<::std::size_t, Rank> other_extents;
+    Equal equal;
+    ViewScan<Rank> scan;
+    ::std::array<::std::optional<T>, span * span> left;    ///< Copies of the neighbourhood, row by row (i.e. `span` rows of `span` columns).
+    ::std::array<::std::optional<U>, span * span> right;
+
+    constexpr bool evaluate() const { return (extents == other_extents && scan.mismatches == 0); }
+
+    static void print_coordinates(::std::ostream & os, const ::std::array<::std::size_t, Rank> & index)
+    {
+        os << '(';
+        for(::std::size_t d = 0; d < Rank; ++d)
+            os << (d > 0 ? ", " : "") << index[d];
+        os << ')';
+    }
+
+    /// The first row and column of the neighbourhood, in the last two coordinates (or just the last one, for one dimension).
+    constexpr ::std::size_t corner(const ::std::size_t d) const { return (scan.first[d] < radius) ? 0 : scan.first[d] - radius; }
+
+    friend ::std::ostream & operator<<(::std::ostream & os, const ViewExpression & this_)
+    {
+        ::std::size_t size = 1;
+        for(const ::std::size_t extent : this_.extents)
+            size *= extent;
+
+        if(this_.extents != this_.other_extents)
+        {
+            os << "extents differ: ";
+            print_coordinates(os, this_.extents);
+            os << " != ";
+            print_coordinates(os, this_.other_extents);
+            return os;
+        }
+        if(this_.scan.mismatches == 0)
+            return os << size << " elements equal" << this_.equal;
+
+        const ::std::size_t row = Rank - 1 - (Rank > 1);
+        const ::std::size_t column = Rank - 1;
+        const ::std::size_t cell = (Rank > 1 ? (this_.scan.first[row] - this_.corner(row)) * span : 0) + (this_.scan.first[column] - this_.corner(column));
+        print_coordinates(os, this_.scan.first);
+        os << ": ";
+        print(os, *this_.left[cell]);
+        os << " vs. ";
+        print(os, *this_.right[cell]);
+        os << "; " << this_.scan.mismatches << " of " << size << " elements differ" << this_.equal << '\n';
+
+        // All cells (and the headers) right-aligned to the same width.
+        ::std::array<::std::string, span * span> cells;
+        ::std::size_t width = 0;
+        for(::std::size_t i = 0; i < span * span; ++i)
+        {
+            if(!this_.left[i])
+                continue;
+            ::std::ostringstream text;
+            print(text, *this_.left[i]);
+            if(!this_.equal(*this_.left[i], *this_.right[i]))
+            {
+                text << '/';
+                print(text, *this_.right[i]);
+            }
+            cells[i] = text.str();
+            width = ::std::max(width, cells[i].size());
+        }
+        const auto label = [](::std::size_t i) { return '[' + ::std::to_string(i) + ']'; };
+        const ::std::size_t rows = (Rank > 1) ? span : 1;
+        const ::std::size_t margin = 2 + ((Rank > 1) ? label(this_.corner(row) + rows - 1).size() : 0);
+        for(::std::size_t c = 0; c < span && this_.left[c]; ++c)
+            width = ::std::max(width, label(this_.corner(column) + c).size());
+
+        os << ::std::string(margin, ' ');
+        for(::std::size_t c = 0; c < span && this_.left[c]; ++c)
+            os << ' ' << ::std::setw(static_cast<int>(width)) << label(this_.corner(column) + c);
+        os << '\n';
+        for(::std::size_t r = 0; r < rows; ++r)
+        {
+            if(!this_.left[r * span])
+                continue;
+            os << ::std::setw(static_cast<int>(margin)) << ((Rank > 1) ? label(this_.corner(row) + r) : ::std::string());
+            for(::std::size_t c = 0; c < span && this_.left[r * span + c]; ++c)
+                os << ' ' << ::std::setw(static_cast<int>(width)) << cells[r * span + c];
+            os << '\n';
+        }
+        return os;
+    }
+};
+
+#endif // CPP_VERIFY_DECOMPOSE
+
+
+/// Compare two views of equal extents element by element, either exactly or within a tolerance.
+template<typename A, typename B, typename Equal>
+auto compare_views(const char * code, const A & view_a, const B & view_b, const Equal & equal)
+{
+    const auto & a = to_view(view_a);
+    const auto & b = to_view(view_b);
+    constexpr ::std::size_t Rank = ::std::decay_t<decltype(a)>::rank;
+    static_assert(Rank == ::std::decay_t<decltype(b)>::rank, "verify_equal() compares views of the same rank.");
+
+    const bool same_extents = (a.extents == b.extents);
+    const ViewScan<Rank> scan = same_extents ? scan_views(a, b, equal) : ViewScan<Rank>{0, {}};
+
+#if CPP_VERIFY_DECOMPOSE
+    using T = ::std::remove_const_t<typename ::std::decay_t<decltype(a)>::element_type>;
+    using U = ::std::remove_const_t<typename ::std::decay_t<decltype(b)>::element_type>;
+    using Expression = ViewExpression<T, U, Rank, Equal>;
+    Expression x{a.extents, b.extents, equal, scan, {}, {}};
+    if(same_extents && scan.mismatches > 0)
+    {
+        // Copy the neighbourhood, as far as it lies within the views.
+        const ::std::size_t row = Rank - 1 - (Rank > 1);
+        const ::std::size_t column = Rank - 1;
+        auto index = scan.first;
+        for(::std::size_t r = 0; r < ((Rank > 1) ? Expression::span : 1); ++r)
+        for(::std::size_t c = 0; c < Expression::span; ++c)
+        {
+            if(Rank > 1)
+                index[row] = x.corner(row) + r;
+            index[column] = x.corner(column) + c;
+            if(index[row] < a.extents[row] && index[column] < a.extents[column])
+            {
+                x.left[r * Expression::span + c] = a[index];
+                x.right[r * Expression::span + c] = b[index];
+            }
+        }
+    }
+    return make_decomposition(code, x);
+#else
+    return Condition(code, same_extents && scan.mismatches == 0);
+#endif
+}
+
+template<typename A, typename B>
+auto check_views(const char * code, const A & a, const B & b)
+{
+    return compare_views(code, a, b, Exactly());
+}
+
+template<typename A, typename B, typename M>
+auto check_views(const char * code, const A & a, const B & b, const M & tolerance)
+{
+    return compare_views(code, a, b, Tolerance<M>{tolerance});
+}
+
+}
+
+#endif
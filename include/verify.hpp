@@ -26,18 +26,59 @@
 ///               std::cout << "Yeah, we passed the test (" << !fail << ")!" << std::endl;
 ///           ```
 ///
-///           TODO:
-///           Aggregation into complex conditions via (short-circuit) `operator&&`, `operator||` might be added in the future.
-///           Example: `if(auto pass = verify(a < b) && verify(c)) std::cout << "passed: " << pass << std::endl;`
-///           Avoiding the evaluation of `c` might be tricky, thought. (Note: think about https://en.wikibooks.org/wiki/More_C%2B%2B_Idioms/Return_Type_Resolver)
+///           Since C++20, `verify(a <=> b)` prints the resulting ordering (e.g. "verify((1 <=> 2) == std::strong_ordering::less) => true"),
+///           and holds if `a` and `b` are ordered at all. Relational comparisons call the operands' own operator (e.g. `operator<`,
+///           or else `<=>`) exactly once, just like the language does, and printing doesn't compare again.
 ///
-///           Further expression decomposition (more operators, more depth) might be added, too (e.g. `verify(a < b && c < d)`).
-///           But that involves careful decomposition along the operator precedence, and might be hard to test.
+///           Floating-point values compare with a tolerance via `verify(x == within_abs(y, 1e-9))`, `within_rel(y, 1e-6)` or `within_ulps(y, 4)`.
+///           The output then shows the difference and the tolerance, too (e.g. "verify(0.1 == 0.2 (absolute difference 0.1 > 1e-09))").
+///
+///           Equality of long strings (`std::string`, `std::string_view`, `const char *`) prints just the context of their first difference,
+///           with its offset, line and column, instead of both strings in full (see `CPP_VERIFY_STRING_CONTEXT`).
+///           Containers (and other ranges) print element-wise, without an `operator<<` of their own. Their equality prints
+///           a bounded diff, i.e. just the inserted and deleted elements with their indices (see `CPP_VERIFY_DIFF_EDITS`).
+///           Sets and maps print the keys found on one side only, and the keys whose values differ.
+///           Structs without an `operator<<` print field by field, and their equality prints just the fields that differ.
+///           Equality of bit flags (`verify(x == bits(y))`, `std::bitset`, `std::vector<bool>`) prints the positions of the differing bits.
+///
+///           Atomic operands (e.g. `verify(counter < limit)` with a `std::atomic` counter) are loaded exactly once,
+///           with `CPP_VERIFY_ATOMIC_MEMORY_ORDER` (relaxed by default), and the value printed is the one compared.
+///           Volatile operands are read exactly once, too.
+///
+///           The result of `verify()` refers to operands that are too large to be copied cheaply, so it must not outlive them.
+///           `verify_owned(x)` moves rvalue operands (i.e. temporaries) into its result instead, and still refers to lvalues:
+///           ```
+///           auto fail = !verify_owned(make_string() == expected); // Keeps the string, but refers to `expected`.
+///           ```
+///           Thus, its result may be returned, stored in containers or handed to other threads, without copying any operand.
+///
+///           Aggregation into complex conditions keeps the decomposition of every evaluated operand,
+///           if the right-hand side is deferred via `verify_lazily(...)`:
+///           ```
+///           if(auto pass = verify(a < b) && verify_lazily(c)) std::cout << "passed: " << pass << std::endl;
+///           ```
+///           Just like the built-in `operator&&` (and `operator||`), `c` is only evaluated if `verify(a < b)` doesn't decide the result on its own.
+///           Its temporaries are moved into the result (like by `verify_owned()`), as they don't live beyond that evaluation.
+///           (Plain `verify(a < b) && verify(c)` still works, too -- but yields a mere `bool`.)
+///
+///           Decomposition of `&&` and `||` inside one `verify()` (e.g. `verify(a < b && c != d)`) is rejected at compile time, deliberately:
+///           Any overloaded `operator&&` evaluates its right-hand side before it is called, which would break `verify(p && p->ok())`.
+///           And `c != d` is already a plain `bool` at that point anyway, so its operands couldn't be captured.
+///           Write `verify(a < b) && verify_lazily(c != d)` instead.
+///
+///           Defining `CPP_VERIFY_DECOMPOSE=0` (e.g. for release builds) turns off the decomposition altogether:
+///           `verify(x)` then costs exactly what `static_cast<bool>(x)` costs, and only the code is printed
+///           (e.g. "verify(a < b) => true"). Storing, negating and printing the return value still compile unchanged.
+///           The rendering of values and diffs (and the headers it needs, like `<sstream>`) isn't even compiled then.
 //////
 
 #ifndef CPP_VERIFY_HPP
 #define CPP_VERIFY_HPP
 
+#ifndef CPP_VERIFY_DECOMPOSE
+    #define CPP_VERIFY_DECOMPOSE 1
+#endif
+
 #if defined(__clang__)
     #define CPP_VERIFY__IGNORE_SUPERFLUOUS_WARNINGS(around) \
         _Pragma("clang diagnostic push") \
@@ -61,10 +102,12 @@
 // - or -
 // 3b) only the left-hand-side sub-expression in a `FirstOperand`, when `x` is a binary expression,
 //     because the `operator<<` has precedence over all comparison operators.
-// 4b) The `FirstOperand` itself offers the set of comparison operators (==,!=,<=,>=,<,>),
+// 4b) The `FirstOperand` itself offers the set of comparison operators (==,!=,<=,>=,<,>, and <=> since C++20),
 // 5b) which captures the right-hand-side sub-expression of the binary expression `x`,
 // 6b) which is delivered as a `BinaryExpression` to `make_decomposition()` via `finish()`.
 
+#if CPP_VERIFY_DECOMPOSE
+
 #define verify(x) \
     CPP_VERIFY__IGNORE_SUPERFLUOUS_WARNINGS( \
         \
@@ -72,13 +115,67 @@
         \
     )   //                     (1)        (2)   (3ff)
 
+#else
+
+// Without decomposition, only the code is kept alongside the boolean result.
+#define verify(x) \
+    (CppVerify::Condition(#x, static_cast<bool>(x)))
+
+#endif
+
+// Just like `verify(x)`, but moving temporaries into the result, instead of referring to them.
+#if CPP_VERIFY_DECOMPOSE
+
+#define verify_owned(x) \
+    CPP_VERIFY__IGNORE_SUPERFLUOUS_WARNINGS( \
+        ((CppVerify::decompose_owned(#x) << x).finish()) \
+    )
+
+#else
+
+#define verify_owned(x) \
+    (CppVerify::Condition(#x, static_cast<bool>(x)))
+
+#endif
+
 // == Show is Over ==
 //
 // The rest is implementation.
 //////
 
-#include <iosfwd>
-#include <sstream>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <ostream>
+#include <type_traits>
+#include <utility>
+
+// Only the decomposition renders values (and diffs) into strings.
+#if CPP_VERIFY_DECOMPOSE
+    #include <algorithm>
+    #include <atomic>
+    #include <bitset>
+    #include <iomanip>
+    #include <sstream>
+    #include <string>
+    #include <string_view>
+    #include <vector>
+#endif
+
+#if defined(__has_include)
+    #if __has_include(<version>)
+        #include <version>
+    #endif
+#endif
+
+#if defined(__cpp_impl_three_way_comparison) && defined(__cpp_lib_three_way_comparison)
+    #define CPP_VERIFY__THREE_WAY 1
+    #include <compare>
+#else
+    #define CPP_VERIFY__THREE_WAY 0
+#endif
 
 namespace CppVerify {
 
@@ -97,35 +194,1077 @@ inline ::std::ostream & operator<<(::std::ostream & os, const LT) { return os <<
 inline ::std::ostream & operator<<(::std::ostream & os, const GT) { return os << " > ";  }
 
 
+//////
+// == Floating-Point Tolerance ==
+//
+// `verify(x == within_abs(y, 1e-9))`, `verify(x == within_rel(y, 1e-6))` and `verify(x == within_ulps(y, 4))`
+// compare with a tolerance, instead of the raw `==`. The tolerance is carried by the right-hand operand (`Within`),
+// whose type selects the comparison tag (ABS_EQ, REL_EQ, ULP_EQ).
+
+#if defined(__has_builtin)
+    #if __has_builtin(__builtin_bit_cast)
+        #define CPP_VERIFY__BIT_CAST(To, from) __builtin_bit_cast(To, from)
+    #endif
+#endif
+
+#ifdef CPP_VERIFY__BIT_CAST
+    #define CPP_VERIFY__BIT_CAST_CONSTEXPR constexpr
+#else
+    #define CPP_VERIFY__BIT_CAST_CONSTEXPR
+#endif
+
+template<typename To, typename From> CPP_VERIFY__BIT_CAST_CONSTEXPR To bit_cast(const From & from)
+{
+    static_assert(sizeof(To) == sizeof(From), "bit_cast needs equally sized types");
+#ifdef CPP_VERIFY__BIT_CAST
+    return CPP_VERIFY__BIT_CAST(To, from);
+#else
+    To to;
+    ::std::memcpy(&to, &from, sizeof(To));
+    return to;
+#endif
+}
+
+template<typename T> constexpr T absolute(const T x) { return (x < 0) ? -x : x; }
+template<typename T, typename U> constexpr auto maximum(const T x, const U y) { return (x < y) ? y : x; }
+
+template<typename F> struct FloatBits;
+template<> struct FloatBits<float>  { using type = ::std::uint32_t; };
+template<> struct FloatBits<double> { using type = ::std::uint64_t; };
+
+/// Map the bits of a float onto an unsigned integer, such that consecutive floats map onto consecutive integers (modulo 2^N).
+/// Negative values are negated in two's complement, so -0.0 and +0.0 coincide.
+template<typename F> CPP_VERIFY__BIT_CAST_CONSTEXPR typename FloatBits<F>::type ordered_bits(const F x)
+{
+    using U = typename FloatBits<F>::type;
+    const U bits = bit_cast<U>(x);
+    const U sign = bits >> (8 * sizeof(U) - 1);
+    const U magnitude = bits & ~(U(1) << (8 * sizeof(U) - 1));
+    return (magnitude ^ (U(0) - sign)) + sign;
+}
+
+/// Amount of representable floats between `x` and `y`, or the maximum if any of them is NaN.
+template<typename F> CPP_VERIFY__BIT_CAST_CONSTEXPR typename FloatBits<F>::type ulp_distance(const F x, const F y)
+{
+    using U = typename FloatBits<F>::type;
+    using S = typename ::std::make_signed<U>::type;
+    const U ox = ordered_bits(x);
+    const U oy = ordered_bits(y);
+    const U distance = (static_cast<S>(ox) < static_cast<S>(oy)) ? (oy - ox) : (ox - oy);
+    return ((x == x) & (y == y)) ? distance : ::std::numeric_limits<U>::max();
+}
+
+template<typename Tolerance, typename T, typename M> struct Within
+{
+    T value;
+    M margin;
+};
+
+// Equal, or at most `margin` apart.
+struct ABS_EQ
+{
+    /// Equal values differ by nothing, even infinite ones.
+    template<typename T1, typename T, typename M> static constexpr auto difference(const T1 & op1, const Within<ABS_EQ, T, M> & op2)
+    {
+        using Difference = decltype(absolute(op1 - op2.value));
+        return (op1 == op2.value) ? Difference(0) : absolute(op1 - op2.value);
+    }
+
+    template<typename T1, typename T, typename M> static constexpr bool evaluate(const T1 & op1, const Within<ABS_EQ, T, M> & op2)
+    {
+        return (op1 == op2.value) | (absolute(op1 - op2.value) <= op2.margin);
+    }
+};
+
+// Equal, or apart by at most `margin` times the larger magnitude.
+struct REL_EQ
+{
+    /// Equal values differ by nothing, even zeros (instead of 0/0) and infinite ones.
+    template<typename T1, typename T, typename M> static constexpr auto difference(const T1 & op1, const Within<REL_EQ, T, M> & op2)
+    {
+        using Difference = decltype(absolute(op1 - op2.value) / maximum(absolute(op1), absolute(op2.value)));
+        return (op1 == op2.value) ? Difference(0) : absolute(op1 - op2.value) / maximum(absolute(op1), absolute(op2.value));
+    }
+
+    template<typename T1, typename T, typename M> static constexpr bool evaluate(const T1 & op1, const Within<REL_EQ, T, M> & op2)
+    {
+        return (op1 == op2.value) | (absolute(op1 - op2.value) <= op2.margin * maximum(absolute(op1), absolute(op2.value)));
+    }
+};
+
+// At most `margin` representable values apart.
+struct ULP_EQ
+{
+    template<typename T1, typename T, typename M> static CPP_VERIFY__BIT_CAST_CONSTEXPR auto difference(const T1 & op1, const Within<ULP_EQ, T, M> & op2)
+    {
+        static_assert(::std::is_same<T1, T>::value, "within_ulps() compares floats of the same type only");
+        return ulp_distance<T>(op1, op2.value);
+    }
+
+    template<typename T1, typename T, typename M> static CPP_VERIFY__BIT_CAST_CONSTEXPR bool evaluate(const T1 & op1, const Within<ULP_EQ, T, M> & op2)
+    {
+        return (op1 == op1) & (op2.value == op2.value) & (difference(op1, op2) <= op2.margin);
+    }
+};
+
+inline ::std::ostream & operator<<(::std::ostream & os, const ABS_EQ) { return os << " == "; }
+inline ::std::ostream & operator<<(::std::ostream & os, const REL_EQ) { return os << " == "; }
+inline ::std::ostream & operator<<(::std::ostream & os, const ULP_EQ) { return os << " == "; }
+
+inline const char * name_of(const ABS_EQ) { return "absolute difference"; }
+inline const char * name_of(const REL_EQ) { return "relative difference"; }
+inline const char * name_of(const ULP_EQ) { return "difference in ulps"; }
+
+template<typename T, typename M> constexpr auto within_abs(const T & value, const M & margin) { return Within<ABS_EQ, T, M>{value, margin}; }
+template<typename T, typename M> constexpr auto within_rel(const T & value, const M & margin) { return Within<REL_EQ, T, M>{value, margin}; }
+template<typename T> constexpr auto within_ulps(const T & value, const typename FloatBits<T>::type margin) { return Within<ULP_EQ, T, typename FloatBits<T>::type>{value, margin}; }
+
+// Also without decomposition (see CPP_VERIFY_DECOMPOSE), `x == within_...(y, margin)` has to work.
+template<typename T1, typename Tolerance, typename T, typename M> constexpr bool operator==(const T1 & op1, const Within<Tolerance, T, M> & op2) { return Tolerance::evaluate(op1, op2); }
+template<typename T1, typename Tolerance, typename T, typename M> constexpr bool operator!=(const T1 & op1, const Within<Tolerance, T, M> & op2) { return !Tolerance::evaluate(op1, op2); }
+
+
+#if CPP_VERIFY__THREE_WAY
+
+struct SPACESHIP { template<typename T1, typename T2> static constexpr auto evaluate(const T1 & op1, const T2 & op2){ return (op1 <=> op2); } };
+
+inline ::std::ostream & operator<<(::std::ostream & os, const SPACESHIP) { return os << " <=> "; }
+
+/// Derive the boolean result of a comparison from an ordering, i.e. from the result of `<=>`.
+/// For `verify(a <=> b)` itself, the result is whether `a` and `b` are ordered at all (i.e. not unordered).
+template<typename Comparison> struct FromOrdering;
+template<> struct FromOrdering<EQ>        { template<typename O> static constexpr bool evaluate(O o) { return (o == 0); } };
+template<> struct FromOrdering<NE>        { template<typename O> static constexpr bool evaluate(O o) { return (o != 0); } };
+template<> struct FromOrdering<LE>        { template<typename O> static constexpr bool evaluate(O o) { return (o <= 0); } };
+template<> struct FromOrdering<GE>        { template<typename O> static constexpr bool evaluate(O o) { return (o >= 0); } };
+template<> struct FromOrdering<LT>        { template<typename O> static constexpr bool evaluate(O o) { return (o <  0); } };
+template<> struct FromOrdering<GT>        { template<typename O> static constexpr bool evaluate(O o) { return (o >  0); } };
+template<> struct FromOrdering<SPACESHIP> { template<typename O> static constexpr bool evaluate(O o) { return (o == 0) || (o < 0) || (o > 0); } };
+
+template<typename T> struct is_ordering : ::std::false_type { };
+template<> struct is_ordering<::std::partial_ordering> : ::std::true_type { };
+template<> struct is_ordering<::std::weak_ordering> : ::std::true_type { };
+template<> struct is_ordering<::std::strong_ordering> : ::std::true_type { };
+
+inline const char * name_of(::std::partial_ordering o) { return (o < 0) ? "less" : (o > 0) ? "greater" : (o == 0) ? "equivalent" : "unordered"; }
+inline const char * name_of(::std::weak_ordering o)    { return (o < 0) ? "less" : (o > 0) ? "greater" : "equivalent"; }
+inline const char * name_of(::std::strong_ordering o)  { return (o < 0) ? "less" : (o > 0) ? "greater" : "equal"; }
+
+inline ::std::ostream & operator<<(::std::ostream & os, const ::std::partial_ordering o) { return os << "std::partial_ordering::" << name_of(o); }
+inline ::std::ostream & operator<<(::std::ostream & os, const ::std::weak_ordering o)    { return os << "std::weak_ordering::"    << name_of(o); }
+inline ::std::ostream & operator<<(::std::ostream & os, const ::std::strong_ordering o)  { return os << "std::strong_ordering::"  << name_of(o); }
+
+#endif // CPP_VERIFY__THREE_WAY
+
+
+/// Expressions that own (some of) their operands (see `verify_owned()`) are kept movable, all others immutable.
+/// So are the results of verify() that keep such expressions.
+template<class Expression, class = void> struct owns_operands : ::std::false_type { };
+template<class Expression> struct owns_operands<Expression, typename ::std::enable_if<Expression::owning>::type> : ::std::true_type { };
+
+
+//////
+// == Printing of Values ==
+//
+// `print()` streams a value via its `operator<<`. Ranges without one (e.g. `std::vector`) are printed element-wise,
+// but at most `CPP_VERIFY_RANGE_ELEMENTS` elements of them, e.g. "{1, 2, 3, 4, 5, 6, 7, 8, ...} (1000 elements)".
+// Aggregates without one (i.e. plain structs) are printed field by field, e.g. "{8080, localhost, 0.5}".
+
+#ifndef CPP_VERIFY_RANGE_ELEMENTS
+    #define CPP_VERIFY_RANGE_ELEMENTS 8
+#endif
+
+/// Containers and other ranges, i.e. anything with `std::begin()` and `std::end()` -- but no built-in array, which compares as a pointer.
+template<typename T, typename = void> struct is_range : ::std::false_type { };
+template<typename T> struct is_range<T, ::std::void_t<decltype(::std::begin(::std::declval<const T &>())), decltype(::std::end(::std::declval<const T &>()))>>
+    : ::std::integral_constant<bool, !::std::is_array<T>::value> { };
+
+#if CPP_VERIFY_DECOMPOSE
+
+#define CPP_VERIFY__AGGREGATE_FIELDS 32
+
+template<typename T, typename = void> struct is_streamable : ::std::false_type { };
+template<typename T> struct is_streamable<T, ::std::void_t<decltype(::std::declval<::std::ostream &>() << ::std::declval<const T &>())>> : ::std::true_type { };
+
+template<typename T> struct is_pair : ::std::false_type { };
+template<typename T1, typename T2> struct is_pair<::std::pair<T1, T2>> : ::std::true_type { };
+
+/// Converts to anything, so that the amount of initializers an aggregate takes can be counted (like Boost.PFR does).
+struct AnyField
+{
+    template<typename T> operator T() const;
+};
+
+template<typename T, typename Indices, typename = void> struct is_initializable : ::std::false_type { };
+template<typename T, ::std::size_t... I> struct is_initializable<T, ::std::index_sequence<I...>, ::std::void_t<decltype(T{ (static_cast<void>(I), AnyField())... })>>
+    : ::std::true_type { };
+
+/// The amount of fields of an aggregate, i.e. the most initializers its braced initialization takes.
+template<typename T, ::std::size_t N = 0> constexpr ::std::size_t field_count()
+{
+    if constexpr(N <= CPP_VERIFY__AGGREGATE_FIELDS && is_initializable<T, ::std::make_index_sequence<N + 1>>::value)
+        return field_count<T, N + 1>();
+    else
+        return N;
+}
+
+/// Structs and classes with public fields only (and no `operator<<`), up to `CPP_VERIFY__AGGREGATE_FIELDS` of them,
+/// but no built-in arrays, unions or containers (e.g. `std::array`). Aggregates with bases or built-in arrays as fields aren't supported.
+template<typename T, typename = void> struct is_aggregate : ::std::false_type { };
+template<typename T> struct is_aggregate<T, typename ::std::enable_if<
+    ::std::is_aggregate<T>::value && !::std::is_array<T>::value && !::std::is_union<T>::value && !is_streamable<T>::value && !is_range<T>::value>::type>
+    : ::std::integral_constant<bool, field_count<T>() <= CPP_VERIFY__AGGREGATE_FIELDS> { };
+
+/// Call `f` with all fields of the aggregate `x`, via a structured binding of their (compile-time) count.
+template<typename T, typename F> decltype(auto) apply_fields(const T & x, F && f)
+{
+    constexpr ::std::size_t N = field_count<T>();
+    if constexpr(N == 0)
+    {
+        static_cast<void>(x);
+        return f();
+    }
+#define CPP_VERIFY__APPLY_FIELDS(n, ...) \
+    else if constexpr(N == n) \
+    { \
+        const auto & [__VA_ARGS__] = x; \
+        return f(__VA_ARGS__); \
+    }
+    CPP_VERIFY__APPLY_FIELDS(1, f0)
+    CPP_VERIFY__APPLY_FIELDS(2, f0, f1)
+    CPP_VERIFY__APPLY_FIELDS(3, f0, f1, f2)
+    CPP_VERIFY__APPLY_FIELDS(4, f0, f1, f2, f3)
+    CPP_VERIFY__APPLY_FIELDS(5, f0, f1, f2, f3, f4)
+    CPP_VERIFY__APPLY_FIELDS(6, f0, f1, f2, f3, f4, f5)
+    CPP_VERIFY__APPLY_FIELDS(7, f0, f1, f2, f3, f4, f5, f6)
+    CPP_VERIFY__APPLY_FIELDS(8, f0, f1, f2, f3, f4, f5, f6, f7)
+    CPP_VERIFY__APPLY_FIELDS(9, f0, f1, f2, f3, f4, f5, f6, f7, f8)
+    CPP_VERIFY__APPLY_FIELDS(10, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9)
+    CPP_VERIFY__APPLY_FIELDS(11, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10)
+    CPP_VERIFY__APPLY_FIELDS(12, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11)
+    CPP_VERIFY__APPLY_FIELDS(13, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12)
+    CPP_VERIFY__APPLY_FIELDS(14, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13)
+    CPP_VERIFY__APPLY_FIELDS(15, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14)
+    CPP_VERIFY__APPLY_FIELDS(16, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15)
+    CPP_VERIFY__APPLY_FIELDS(17, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16)
+    CPP_VERIFY__APPLY_FIELDS(18, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17)
+    CPP_VERIFY__APPLY_FIELDS(19, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18)
+    CPP_VERIFY__APPLY_FIELDS(20, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19)
+    CPP_VERIFY__APPLY_FIELDS(21, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20)
+    CPP_VERIFY__APPLY_FIELDS(22, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21)
+    CPP_VERIFY__APPLY_FIELDS(23, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22)
+    CPP_VERIFY__APPLY_FIELDS(24, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23)
+    CPP_VERIFY__APPLY_FIELDS(25, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24)
+    CPP_VERIFY__APPLY_FIELDS(26, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25)
+    CPP_VERIFY__APPLY_FIELDS(27, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26)
+    CPP_VERIFY__APPLY_FIELDS(28, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27)
+    CPP_VERIFY__APPLY_FIELDS(29, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28)
+    CPP_VERIFY__APPLY_FIELDS(30, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29)
+    CPP_VERIFY__APPLY_FIELDS(31, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30)
+    CPP_VERIFY__APPLY_FIELDS(32, f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15, f16, f17, f18, f19, f20, f21, f22, f23, f24, f25, f26, f27, f28, f29, f30, f31)
+#undef CPP_VERIFY__APPLY_FIELDS
+}
+
+template<typename T> void print(::std::ostream & os, const T & value)
+{
+    if constexpr(!is_streamable<T>::value && is_pair<T>::value)
+    {
+        os << '(';
+        print(os, value.first);
+        os << ", ";
+        print(os, value.second);
+        os << ')';
+    }
+    else if constexpr(!is_streamable<T>::value && is_range<T>::value)
+    {
+        ::std::size_t i = 0;
+        os << '{';
+        for(const auto & element : value)
+        {
+            if(i == CPP_VERIFY_RANGE_ELEMENTS)
+            {
+                os << ", ...";
+                break;
+            }
+            if(i++ > 0)
+                os << ", ";
+            print(os, element);
+        }
+        os << '}';
+        if(i == CPP_VERIFY_RANGE_ELEMENTS)
+        {
+            const auto size = ::std::distance(::std::begin(value), ::std::end(value));
+            if(size > static_cast<decltype(size)>(i))
+                os << " (" << size << " elements)";
+        }
+    }
+    else if constexpr(is_aggregate<T>::value)
+    {
+        os << '{';
+        apply_fields(value, [&os](const auto &... fields) {
+            const char * separator = "";
+            ((os << separator, print(os, fields), separator = ", "), ...);
+        });
+        os << '}';
+    }
+    else
+        os << value;
+}
+
+
+//////
+// == Printing of Comparisons ==
+//
+// `explain()` prints the operands of a comparison. The default just puts the comparison between both operands.
+// More specific overloads (with a higher `Rank`) customize the output for specific operands or comparisons.
+
+template<unsigned N> struct Rank : Rank<N - 1> { };
+template<> struct Rank<0> { };
+
+using TopRank = Rank<15>;
+
+template<typename L, typename Comparison, typename R>
+void explain(::std::ostream & os, const L & op1, const Comparison comparison, const R & op2, Rank<0>)
+{
+    print(os, op1);
+    os << comparison;
+    print(os, op2);
+}
+
+/// Comparisons with a tolerance (and their negation by `!=`) print the difference, and whether it is within the tolerance.
+template<typename L, typename Comparison, typename Tolerance, typename T, typename M, typename = typename ::std::enable_if<
+    ::std::is_same<Comparison, Tolerance>::value || ::std::is_same<Comparison, NE>::value>::type>
+void explain(::std::ostream & os, const L & op1, const Comparison comparison, const Within<Tolerance, T, M> & op2, Rank<1>)
+{
+    // Round-trip precision, so that distinct values are shown distinctly.
+    // Whether they are within the tolerance is up to the tolerance itself, not to (another) comparison of the difference.
+    const bool within = Tolerance::evaluate(op1, op2);
+    os << ::std::setprecision(::std::numeric_limits<T>::max_digits10)
+       << op1 << comparison << op2.value
+       << " (" << name_of(Tolerance()) << ' ' << Tolerance::difference(op1, op2) << (within ? " <= " : " > ") << op2.margin << ')';
+}
+
+
+// Equality of strings (`std::string`, `std::string_view`, character arrays and pointers) prints only the context
+// of the first difference, if either string is longer than `CPP_VERIFY_STRING_CONTEXT` characters:
+// ```
+// 51200 characters == 51200 characters, first difference at offset 1234 (line 5, column 17)
+//   ..."name": "alice",\n    "age": 31...
+//   ..."name": "alicE",\n    "age": 31...
+//                   ^
+// ```
+// That's at most `CPP_VERIFY_STRING_CONTEXT` characters before and after the difference, escaped like in a literal.
+
+#ifndef CPP_VERIFY_STRING_CONTEXT
+    #define CPP_VERIFY_STRING_CONTEXT 32
+#endif
+
+template<typename T> struct is_string : ::std::false_type { };
+template<typename Traits, typename Allocator> struct is_string<::std::basic_string<char, Traits, Allocator>> : ::std::true_type { };
+template<typename Traits> struct is_string<::std::basic_string_view<char, Traits>> : ::std::true_type { };
+template<> struct is_string<char *> : ::std::true_type { };
+template<> struct is_string<const char *> : ::std::true_type { };
+template<::std::size_t N> struct is_string<char[N]> : ::std::true_type { };
+template<::std::size_t N> struct is_string<const char[N]> : ::std::true_type { };
+
+template<typename T> constexpr bool is_null_string(const T & s)
+{
+    if constexpr(::std::is_pointer<T>::value)
+        return (s == nullptr);
+    else
+        return false;
+}
+
+/// Offset of the first difference of `a` and `b`, or the length of the shorter one, if it is a prefix of the other.
+inline ::std::size_t first_difference(const ::std::string_view a, const ::std::string_view b)
+{
+    const ::std::size_t n = (a.size() < b.size()) ? a.size() : b.size();
+
+    // Whole blocks are compared by `memcmp()` (vectorized by any decent C library), only the differing one character by character.
+    constexpr ::std::size_t block = 64;
+    ::std::size_t i = 0;
+    while(i + block <= n && ::std::memcmp(a.data() + i, b.data() + i, block) == 0)
+        i += block;
+    while(i < n && a[i] == b[i])
+        ++i;
+    return i;
+}
+
+/// Print the characters escaped, like in a string literal, and return the amount of printed characters.
+inline ::std::size_t print_escaped(::std::ostream & os, const ::std::string_view s)
+{
+    ::std::size_t width = 0;
+    for(const char c : s)
+    {
+        switch(c)
+        {
+            case '\n':  os << "\\n";  width += 2; break;
+            case '\r':  os << "\\r";  width += 2; break;
+            case '\t':  os << "\\t";  width += 2; break;
+            case '\\': os << "\\\\"; width += 2; break;
+            default:
+                if(static_cast<unsigned char>(c) < 0x20 || c == 0x7F)
+                {
+                    os << "\\x" << ::std::hex << ::std::setw(2) << ::std::setfill('0') << static_cast<unsigned>(static_cast<unsigned char>(c))
+                       << ::std::dec << ::std::setfill(' ');
+                    width += 4;
+                }
+                else
+                {
+                    os << c;
+                    width += 1;
+                }
+        }
+    }
+    return width;
+}
+
+template<typename L, typename Comparison, typename R, typename = typename ::std::enable_if<
+    is_string<L>::value && is_string<R>::value && (::std::is_same<Comparison, EQ>::value || ::std::is_same<Comparison, NE>::value)>::type>
+void explain(::std::ostream & os, const L & op1, const Comparison comparison, const R & op2, Rank<2>)
+{
+    constexpr ::std::size_t context = CPP_VERIFY_STRING_CONTEXT;
+    if(is_null_string(op1) || is_null_string(op2))
+        return explain(os, op1, comparison, op2, Rank<0>());
+
+    const ::std::string_view a(op1);
+    const ::std::string_view b(op2);
+    if(a.size() <= context && b.size() <= context)
+        return explain(os, op1, comparison, op2, Rank<0>());
+
+    os << a.size() << " characters" << comparison << b.size() << " characters, ";
+    const ::std::size_t first = first_difference(a, b);
+    if(first == a.size() && first == b.size())
+    {
+        os << "no difference";
+        return;
+    }
+
+    const ::std::size_t line_start = (first == 0) ? 0 : a.rfind('\n', first - 1) + 1; // npos + 1 == 0
+    const ::std::size_t lines = static_cast<::std::size_t>(::std::count(a.begin(), a.begin() + static_cast<::std::ptrdiff_t>(first), '\n'));
+    os << "first difference at offset " << first << " (line " << lines + 1 << ", column " << first - line_start + 1 << ")\n";
+
+    // Both strings agree up to the difference, and so do their escaped forms: The caret is below both.
+    const ::std::size_t start = (first < context) ? 0 : first - context;
+    const char * const ellipsis = (start > 0) ? "..." : "";
+    ::std::size_t column = 0;
+    for(const ::std::string_view s : {a, b})
+    {
+        const ::std::string_view after = s.substr(first, context);
+        os << "  " << ellipsis;
+        column = print_escaped(os, s.substr(start, first - start));
+        print_escaped(os, after);
+        os << ((first + after.size() < s.size()) ? "..." : "") << '\n';
+    }
+    os << ::std::string(2 + ::std::strlen(ellipsis) + column, ' ') << "^\n";
+}
+
+
+// Equality of ranges (other than strings) prints the shortest edit script from one to the other, if either holds more than
+// `CPP_VERIFY_RANGE_ELEMENTS` elements. Like in a unified diff, "-" marks elements of the left-hand side, "+" those of the right-hand side:
+// ```
+// 1000000 elements == 1000001 elements, 2 edits:
+//   - [17]: 5
+//   + [17]: 6
+//   + [999999]: 42
+// ```
+// The diff (Myers' O(ND) algorithm) gives up beyond `CPP_VERIFY_DIFF_EDITS` edits or `CPP_VERIFY_DIFF_STEPS` element comparisons.
+// Its memory is bounded by the former, independently of the sizes of the ranges. Then, and for ranges without random access,
+// just the first difference is printed.
+
+#ifndef CPP_VERIFY_DIFF_EDITS
+    #define CPP_VERIFY_DIFF_EDITS 16
+#endif
+
+#ifndef CPP_VERIFY_DIFF_STEPS
+    #define CPP_VERIFY_DIFF_STEPS (::std::size_t(1) << 24)
+#endif
+
+struct Edit
+{
+    bool insertion;         ///< Insertion of `b[index]`, else deletion of `a[index]`.
+    ::std::size_t index;
+};
+
+/// The shortest edit script from `n` elements at `a` to `m` elements at `b` (random-access iterators), or `false` if it takes
+/// more than `max_edits` edits, or more than `max_steps` element comparisons to find it.
+template<typename A, typename B>
+bool myers_diff(const A a, const ::std::size_t n, const B b, const ::std::size_t m, ::std::vector<Edit> & edits,
+                const ::std::size_t max_edits = CPP_VERIFY_DIFF_EDITS, const ::std::size_t max_steps = CPP_VERIFY_DIFF_STEPS)
+{
+    // The common prefix and suffix take no edits, and no steps.
+    ::std::size_t prefix = 0;
+    while(prefix < n && prefix < m && a[prefix] == b[prefix])
+        ++prefix;
+    ::std::size_t suffix = 0;
+    while(prefix + suffix < n && prefix + suffix < m && a[n - 1 - suffix] == b[m - 1 - suffix])
+        ++suffix;
+
+    using Index = ::std::ptrdiff_t;
+    const Index N = static_cast<Index>(n - prefix - suffix);
+    const Index M = static_cast<Index>(m - prefix - suffix);
+    const Index D = static_cast<Index>(max_edits);
+
+    // `v[offset + k]` is the furthest x reached on the diagonal k = x - y. Its state before each round is kept in `trace`.
+    const Index offset = D + 1;
+    const ::std::size_t width = static_cast<::std::size_t>(2 * D + 3);
+    ::std::vector<Index> v(width, 0);
+    ::std::vector<Index> trace;
+    ::std::size_t steps = 0;
+
+    for(Index d = 0; d <= D; ++d)
+    {
+        trace.insert(trace.end(), v.begin(), v.end());
+        for(Index k = -d; k <= d; k += 2)
+        {
+            const bool down = (k == -d || (k != d && v[offset + k - 1] < v[offset + k + 1]));
+            Index x = down ? v[offset + k + 1] : v[offset + k - 1] + 1;
+            Index y = x - k;
+            while(x < N && y < M && a[prefix + x] == b[prefix + y])
+            {
+                ++x, ++y;
+                if(++steps > max_steps)
+                    return false;
+            }
+            v[offset + k] = x;
+
+            if(x >= N && y >= M)
+            {
+                // Walk back through the rounds, one edit each.
+                edits.clear();
+                for(; d > 0; --d)
+                {
+                    const Index * const previous = &trace[static_cast<::std::size_t>(d) * width];
+                    k = x - y;
+                    const bool inserted = (k == -d || (k != d && previous[offset + k - 1] < previous[offset + k + 1]));
+                    x = previous[offset + (inserted ? k + 1 : k - 1)];
+                    y = x - (inserted ? k + 1 : k - 1);
+                    edits.push_back(Edit{inserted, prefix + static_cast<::std::size_t>(inserted ? y : x)});
+                }
+                ::std::reverse(edits.begin(), edits.end());
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template<typename L, typename Comparison, typename R, typename = typename ::std::enable_if<
+    is_range<L>::value && is_range<R>::value && !is_string<L>::value && !is_string<R>::value &&
+    (::std::is_same<Comparison, EQ>::value || ::std::is_same<Comparison, NE>::value)>::type>
+void explain(::std::ostream & os, const L & op1, const Comparison comparison, const R & op2, Rank<3>)
+{
+    const auto a = ::std::begin(op1);
+    const auto b = ::std::begin(op2);
+    const auto n = static_cast<::std::size_t>(::std::distance(a, ::std::end(op1)));
+    const auto m = static_cast<::std::size_t>(::std::distance(b, ::std::end(op2)));
+    if(n <= CPP_VERIFY_RANGE_ELEMENTS && m <= CPP_VERIFY_RANGE_ELEMENTS)
+        return explain(os, op1, comparison, op2, Rank<0>());
+
+    os << n << " elements" << comparison << m << " elements, ";
+
+    using Category = typename ::std::iterator_traits<typename ::std::remove_const<decltype(a)>::type>::iterator_category;
+    using OtherCategory = typename ::std::iterator_traits<typename ::std::remove_const<decltype(b)>::type>::iterator_category;
+    const char * reason = "";
+    if constexpr(::std::is_base_of<::std::random_access_iterator_tag, Category>::value && ::std::is_base_of<::std::random_access_iterator_tag, OtherCategory>::value)
+    {
+        ::std::vector<Edit> edits;
+        if(myers_diff(a, n, b, m, edits))
+        {
+            if(edits.empty())
+            {
+                os << "no difference";
+                return;
+            }
+            os << edits.size() << (edits.size() == 1 ? " edit:\n" : " edits:\n");
+            for(const Edit & edit : edits)
+            {
+                os << (edit.insertion ? "  + [" : "  - [") << edit.index << "]: ";
+                if(edit.insertion)
+                    print(os, b[static_cast<::std::ptrdiff_t>(edit.index)]);
+                else
+                    print(os, a[static_cast<::std::ptrdiff_t>(edit.index)]);
+                os << '\n';
+            }
+            return;
+        }
+        reason = "too many edits to list, ";
+    }
+
+    // Just the first difference.
+    auto i = a;
+    auto j = b;
+    ::std::size_t first = 0;
+    for(; first < n && first < m && *i == *j; ++first)
+        ++i, ++j;
+    if(first == n && first == m)
+    {
+        os << "no difference";
+        return;
+    }
+    os << reason << "first difference at [" << first << "]: ";
+    if(first < n)
+        print(os, *i);
+    else
+        os << "(end)";
+    os << " vs. ";
+    if(first < m)
+        print(os, *j);
+    else
+        os << "(end)";
+}
+
+
+// Equality of associative containers with unique keys (sets and maps, ordered or not) prints the keys found on one side only,
+// and -- for maps -- the keys whose values differ. Each side is probed with the keys of the other, i.e. in expected O(n) for
+// unordered containers. At most `CPP_VERIFY_DIFF_EDITS` of them are listed, after their counts:
+// ```
+// 1000 elements == 1001 elements, 1 only left, 2 only right, 1 changed:
+//   - [10.0.0.0/8]: eth0
+//   + [10.1.0.0/16]: eth1
+//   + [10.2.0.0/16]: eth1
+//   ~ [192.168.0.0/16]: eth0 vs. eth2
+// ```
+
+/// Sets and maps, whose `insert()` rejects duplicate keys (unlike that of their multi-variants).
+template<typename T, typename = void> struct is_associative : ::std::false_type { };
+template<typename T> struct is_associative<T, ::std::void_t<typename T::key_type, decltype(::std::declval<const T &>().find(::std::declval<const typename T::key_type &>()))>>
+    : ::std::integral_constant<bool, !::std::is_same<decltype(::std::declval<T &>().insert(::std::declval<const typename T::value_type &>())), typename T::iterator>::value> { };
+
+template<typename T, typename = void> struct is_map : ::std::false_type { };
+template<typename T> struct is_map<T, ::std::void_t<typename T::mapped_type>> : ::std::true_type { };
+
+template<typename T> const auto & key_of(const T & element)
+{
+    if constexpr(is_pair<T>::value)
+        return element.first;
+    else
+        return element;
+}
+
+template<typename L, typename Comparison, typename R, typename = typename ::std::enable_if<
+    is_associative<L>::value && is_associative<R>::value && (is_map<L>::value == is_map<R>::value) &&
+    (::std::is_same<Comparison, EQ>::value || ::std::is_same<Comparison, NE>::value)>::type>
+void explain(::std::ostream & os, const L & op1, const Comparison comparison, const R & op2, Rank<4>)
+{
+    if(op1.size() <= CPP_VERIFY_RANGE_ELEMENTS && op2.size() <= CPP_VERIFY_RANGE_ELEMENTS)
+        return explain(os, op1, comparison, op2, Rank<0>());
+
+    // Only the first few differences are kept for printing, but all of them are counted.
+    struct Difference
+    {
+        char mark;
+        const typename L::value_type * left;
+        const typename R::value_type * right;
+    };
+    ::std::vector<Difference> listed;
+    ::std::size_t only_left = 0, only_right = 0, changed = 0;
+    const auto list = [&listed](const Difference & difference) {
+        if(listed.size() < CPP_VERIFY_DIFF_EDITS)
+            listed.push_back(difference);
+    };
+
+    for(const auto & element : op1)
+    {
+        const auto other = op2.find(key_of(element));
+        if(other == op2.end())
+            ++only_left, list(Difference{'-', &element, nullptr});
+        else if constexpr(is_map<L>::value)
+        {
+            if(!(element.second == other->second))
+                ++changed, list(Difference{'~', &element, &*other});
+        }
+    }
+    for(const auto & element : op2)
+    {
+        if(op1.find(key_of(element)) == op1.end())
+            ++only_right, list(Difference{'+', nullptr, &element});
+    }
+
+    os << op1.size() << " elements" << comparison << op2.size() << " elements, ";
+    if(listed.empty())
+    {
+        os << "no difference";
+        return;
+    }
+    os << only_left << " only left, " << only_right << " only right";
+    if constexpr(is_map<L>::value)
+        os << ", " << changed << " changed";
+    os << ":\n";
+
+    for(const Difference & difference : listed)
+    {
+        const auto & element = difference.left ? *difference.left : *difference.right;
+        os << "  " << difference.mark << ' ';
+        if constexpr(is_map<L>::value)
+        {
+            os << '[';
+            print(os, element.first);
+            os << "]: ";
+            print(os, element.second);
+            if(difference.mark == '~')
+            {
+                os << " vs. ";
+                print(os, difference.right->second);
+            }
+        }
+        else
+            print(os, element);
+        os << '\n';
+    }
+    const ::std::size_t total = only_left + only_right + changed;
+    if(total > listed.size())
+        os << "  ... (" << total - listed.size() << " more)\n";
+}
+
+
+// Equality of aggregates (without an `operator<<`) prints only the fields that differ, by their index:
+// ```
+// 30 fields == 30 fields, 2 differ:
+//   [3]: 8080 vs. 8081
+//   [17]: 0.5 vs. 0.25
+// ```
+// The fields are enumerated at compile time, via structured bindings. Those of trivially copyable aggregates
+// without padding bits are only compared one by one, if their bytes differ at all.
+
+template<typename T, typename = void> struct is_equality_comparable : ::std::false_type { };
+template<typename T> struct is_equality_comparable<T, ::std::void_t<decltype(static_cast<bool>(::std::declval<const T &>() == ::std::declval<const T &>()))>>
+    : ::std::true_type { };
+
+template<typename L, typename Comparison, typename R, typename = typename ::std::enable_if<
+    is_aggregate<L>::value && ::std::is_same<L, R>::value &&
+    (::std::is_same<Comparison, EQ>::value || ::std::is_same<Comparison, NE>::value)>::type>
+void explain(::std::ostream & os, const L & op1, const Comparison comparison, const R & op2, Rank<5>)
+{
+    constexpr ::std::size_t fields = field_count<L>();
+    os << fields << " fields" << comparison << fields << " fields, ";
+
+    if constexpr(::std::is_trivially_copyable<L>::value && ::std::has_unique_object_representations<L>::value)
+    {
+        if(::std::memcmp(&op1, &op2, sizeof(L)) == 0)
+        {
+            os << "no difference";
+            return;
+        }
+    }
+
+    // Only the first few differences are listed, but all of them are counted.
+    ::std::ostringstream listed;
+    ::std::size_t differ = 0;
+    apply_fields(op1, [&](const auto &... left) {
+        apply_fields(op2, [&](const auto &... right) {
+            ::std::size_t i = 0;
+            const auto compare = [&](const auto & x, const auto & y) {
+                if constexpr(is_equality_comparable<::std::decay_t<decltype(x)>>::value)
+                {
+                    if(!(x == y) && differ++ < CPP_VERIFY_DIFF_EDITS)
+                    {
+                        listed << "  [" << i << "]: ";
+                        print(listed, x);
+                        listed << " vs. ";
+                        print(listed, y);
+                        listed << '\n';
+                    }
+                }
+                ++i;
+            };
+            static_cast<void>(compare);
+            (compare(left, right), ...);
+        });
+    });
+
+    if(differ == 0)
+    {
+        os << "no difference";
+        return;
+    }
+    os << differ << ((differ == 1) ? " differs:\n" : " differ:\n") << listed.str();
+    if(differ > CPP_VERIFY_DIFF_EDITS)
+        os << "  ... (" << differ - CPP_VERIFY_DIFF_EDITS << " more)\n";
+}
+
+
+// Equality of bit flags prints the positions of the bits that differ, instead of leaving the XOR to the reader.
+// Unsigned integers (and enums) are marked as flags by `verify(x == bits(y))`, optionally with the names of their bits
+// (`bits(y, names)`, with e.g. `constexpr const char * names[] = {"READ", "WRITE", "EXEC"};`):
+// ```
+// 0x0c == 0x05 (2 bits differ: [0] READ: 0 vs. 1, [3]: 1 vs. 0)
+// ```
+// `std::bitset` and `std::vector<bool>` are flags anyway. Longer than 64 bits, they print one differing bit per line:
+// ```
+// 4096 bits == 4096 bits, 2 bits differ:
+//   [17]: 1 vs. 0
+//   [4000]: 0 vs. 1
+// ```
+// The differences are found word by word (via XOR, popcount and count-trailing-zeros), not bit by bit.
+
+#if defined(__has_builtin)
+    #if __has_builtin(__builtin_popcountll) && __has_builtin(__builtin_ctzll)
+        #define CPP_VERIFY__BIT_BUILTINS 1
+    #endif
+#endif
+
+inline unsigned popcount(::std::uint64_t x)
+{
+#ifdef CPP_VERIFY__BIT_BUILTINS
+    return static_cast<unsigned>(__builtin_popcountll(x));
+#else
+    unsigned count = 0;
+    for(; x != 0; x &= x - 1)
+        ++count;
+    return count;
+#endif
+}
+
+/// The position of the lowest set bit of `x`, which must not be 0.
+inline unsigned countr_zero(::std::uint64_t x)
+{
+#ifdef CPP_VERIFY__BIT_BUILTINS
+    return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+    unsigned count = 0;
+    for(; (x & 1) == 0; x >>= 1)
+        ++count;
+    return count;
+#endif
+}
+
+/// The differing bits of two bit arrays, gathered one XOR-ed word at a time: all are counted, the lowest few are listed.
+struct BitDifferences
+{
+    ::std::size_t count;                                ///< Amount of differing bits.
+    ::std::size_t listed;                               ///< Amount of them in `positions`.
+    ::std::size_t positions[CPP_VERIFY_DIFF_EDITS];     ///< The lowest positions of differing bits, ascending.
+
+    void add(::std::uint64_t differ, const ::std::size_t offset)
+    {
+        count += popcount(differ);
+        for(; differ != 0 && listed < CPP_VERIFY_DIFF_EDITS; differ &= differ - 1)
+            positions[listed++] = offset + countr_zero(differ);
+    }
+};
+
+/// Unsigned integers (or enums) to compare as bit flags, with the names of their lowest `N` bits (if any).
+template<typename T, ::std::size_t N = 0> struct Bits
+{
+    T value;
+    const char * const * names;
+};
+
+template<typename T> constexpr auto word_of(const T x)
+{
+    if constexpr(::std::is_enum<T>::value)
+        return static_cast<typename ::std::make_unsigned<typename ::std::underlying_type<T>::type>::type>(x);
+    else
+        return static_cast<typename ::std::make_unsigned<T>::type>(x);
+}
+
+template<typename T> constexpr auto bits(const T & value)
+{
+    static_assert(::std::is_integral<T>::value || ::std::is_enum<T>::value, "bits() marks integers (or enums) as bit flags.");
+    static_assert(sizeof(T) <= sizeof(::std::uint64_t), "bits() marks integers of up to 64 bits.");
+    return Bits<T>{value, nullptr};
+}
+
+template<typename T, ::std::size_t N> constexpr auto bits(const T & value, const char * const (&names)[N])
+{
+    static_assert(::std::is_integral<T>::value || ::std::is_enum<T>::value, "bits() marks integers (or enums) as bit flags.");
+    static_assert(N <= 8 * sizeof(T), "bits() takes at most one name per bit.");
+    return Bits<T, N>{value, names};
+}
+
+template<typename T1, typename T, ::std::size_t N> constexpr bool operator==(const T1 & op1, const Bits<T, N> & op2) { return (word_of(op1) == word_of(op2.value)); }
+template<typename T1, typename T, ::std::size_t N> constexpr bool operator!=(const T1 & op1, const Bits<T, N> & op2) { return (word_of(op1) != word_of(op2.value)); }
+
+/// Print the listed differences, either inline ("(2 bits differ: [0]: 0 vs. 1, [3]: 1 vs. 0)") or one per line.
+template<typename Left, typename Right>
+void print_bit_differences(::std::ostream & os, const BitDifferences & differences, const Left & left, const Right & right,
+                           const char * const * names, const ::std::size_t named, const bool inline_)
+{
+    if(differences.count == 0)
+    {
+        os << (inline_ ? " (no difference)" : "no difference");
+        return;
+    }
+    os << (inline_ ? " (" : "") << differences.count << ((differences.count == 1) ? " bit differs" : " bits differ") << (inline_ ? ": " : ":\n");
+    for(::std::size_t i = 0; i < differences.listed; ++i)
+    {
+        const ::std::size_t position = differences.positions[i];
+        os << (inline_ ? (i > 0 ? ", " : "") : "  ") << '[' << position << ']';
+        if(position < named)
+            os << ' ' << names[position];
+        os << ": " << left(position) << " vs. " << right(position) << (inline_ ? "" : "\n");
+    }
+    if(differences.count > differences.listed)
+        os << (inline_ ? ", ... (" : "  ... (") << differences.count - differences.listed << (inline_ ? " more)" : " more)\n");
+    if(inline_)
+        os << ')';
+}
+
+template<typename L, typename Comparison, typename T, ::std::size_t N>
+void explain(::std::ostream & os, const L & op1, const Comparison comparison, const Bits<T, N> & op2, Rank<6>)
+{
+    const ::std::uint64_t left = word_of(op1);
+    const ::std::uint64_t right = word_of(op2.value);
+    BitDifferences differences{0, 0, {}};
+    differences.add(left ^ right, 0);
+
+    constexpr int digits = 2 * sizeof(T);
+    os << ::std::hex << ::std::setfill('0') << "0x" << ::std::setw(digits) << left << comparison << "0x" << ::std::setw(digits) << right
+       << ::std::dec << ::std::setfill(' ');
+    print_bit_differences(os, differences,
+                          [left](::std::size_t i) { return (left >> i) & 1; }, [right](::std::size_t i) { return (right >> i) & 1; },
+                          op2.names, N, true);
+}
+
+template<::std::size_t N, typename Comparison, typename = typename ::std::enable_if<
+    ::std::is_same<Comparison, EQ>::value || ::std::is_same<Comparison, NE>::value>::type>
+void explain(::std::ostream & os, const ::std::bitset<N> & op1, const Comparison comparison, const ::std::bitset<N> & op2, Rank<6>)
+{
+    BitDifferences differences{0, 0, {}};
+    if constexpr(N <= 64)
+        differences.add((op1 ^ op2).to_ullong(), 0);
+    else
+    {
+        // XOR and count are word-wise in any implementation, but only libstdc++ offers a word-wise search, too.
+        const ::std::bitset<N> differ = op1 ^ op2;
+        differences.count = differ.count();
+#if defined(__GLIBCXX__)
+        for(::std::size_t i = differ._Find_first(); i < N && differences.listed < CPP_VERIFY_DIFF_EDITS; i = differ._Find_next(i))
+            differences.positions[differences.listed++] = i;
+#else
+        for(::std::size_t i = 0; i < N && differences.listed < differences.count && differences.listed < CPP_VERIFY_DIFF_EDITS; ++i)
+            if(differ[i])
+                differences.positions[differences.listed++] = i;
+#endif
+    }
+
+    if constexpr(N <= 64)
+        os << op1 << comparison << op2;
+    else
+        os << N << " bits" << comparison << N << " bits, ";
+    print_bit_differences(os, differences,
+                          [&op1](::std::size_t i) { return static_cast<int>(op1[i]); }, [&op2](::std::size_t i) { return static_cast<int>(op2[i]); },
+                          nullptr, 0, N <= 64);
+}
+
+template<typename Allocator, typename Comparison, typename = typename ::std::enable_if<
+    ::std::is_same<Comparison, EQ>::value || ::std::is_same<Comparison, NE>::value>::type>
+void explain(::std::ostream & os, const ::std::vector<bool, Allocator> & op1, const Comparison comparison, const ::std::vector<bool, Allocator> & op2, Rank<6>)
+{
+    if(op1.size() <= CPP_VERIFY_RANGE_ELEMENTS && op2.size() <= CPP_VERIFY_RANGE_ELEMENTS)
+        return explain(os, op1, comparison, op2, Rank<0>());
+
+    // Only the bits both have in common are compared (the sizes are printed anyway).
+    const ::std::size_t n = (op1.size() < op2.size()) ? op1.size() : op2.size();
+    BitDifferences differences{0, 0, {}};
+#if defined(__GLIBCXX__)
+    // The words of libstdc++, with the bits of a partial last word masked.
+    using Word = ::std::_Bit_type;
+    constexpr ::std::size_t word_bits = 8 * sizeof(Word);
+    static_assert(word_bits <= 64, "the bits of std::vector<bool> come in words of up to 64 bits");
+    const Word * const a = op1.begin()._M_p;
+    const Word * const b = op2.begin()._M_p;
+    for(::std::size_t w = 0; w * word_bits < n; ++w)
+    {
+        const ::std::size_t rest = n - w * word_bits;
+        const Word mask = (rest < word_bits) ? ((Word(1) << rest) - 1) : ~Word(0);
+        differences.add((a[w] ^ b[w]) & mask, w * word_bits);
+    }
+#else
+    for(::std::size_t i = 0; i < n; ++i)
+    {
+        if(op1[i] != op2[i])
+            differences.add(1, i);
+    }
+#endif
+
+    os << op1.size() << " bits" << comparison << op2.size() << " bits, ";
+    print_bit_differences(os, differences,
+                          [&op1](::std::size_t i) { return static_cast<int>(op1[i]); }, [&op2](::std::size_t i) { return static_cast<int>(op2[i]); },
+                          nullptr, 0, false);
+}
+
+
+
 template<class Expression> struct NegatedDecomposition;
 
 
-template<class Expression> struct [[nodiscard]] Decomposition
+/// The name of the macro an expression stems from, as printed: `Expression::macro` if present, else "verify".
+template<class Expression, class = void> struct macro_name { static constexpr const char * value = "verify"; };
+template<class Expression> struct macro_name<Expression, ::std::void_t<decltype(Expression::macro)>> { static constexpr const char * value = Expression::macro; };
+
+
+template<typename T> struct UnaryExpression;
+template<typename L, typename Comparison, typename R> struct BinaryExpression;
+
+/// Arithmetic values and pointers are captured by value, and compared by built-in operators only.
+template<typename T> struct is_builtin_comparable
+    : ::std::integral_constant<bool, ::std::is_arithmetic<typename ::std::remove_cv<T>::type>::value || ::std::is_pointer<typename ::std::remove_cv<T>::type>::value> { };
+
+/// Expressions that yield the same result when evaluated again, as cheaply as loading a stored flag.
+template<class Expression> struct is_reevaluable : ::std::false_type { };
+template<typename T> struct is_reevaluable<UnaryExpression<T>> : is_builtin_comparable<T> { };
+template<typename L, typename Comparison, typename R> struct is_reevaluable<BinaryExpression<L, Comparison, R>>
+    : ::std::integral_constant<bool, is_builtin_comparable<L>::value && is_builtin_comparable<R>::value> { };
+
+/// The result of an expression, as evaluated once -- or, for comparisons of scalars, evaluated again from their copies instead of being kept.
+/// Thus, e.g. the `Decomposition` of `verify(a < b)` for two ints fits into two machine words, and is returned in registers.
+template<class Expression, class = void> struct Outcome
 {
+    const bool kept;
+
+    constexpr explicit Outcome(bool v) : kept(v) { }
+    constexpr bool of(const Expression &) const { return kept; }
+};
+
+template<class Expression> struct Outcome<Expression, typename ::std::enable_if<is_reevaluable<Expression>::value>::type>
+{
+    constexpr explicit Outcome(bool) { }
+    constexpr bool of(const Expression & x) const { return x.evaluate(); }
+};
+
+
+template<class Expression> struct [[nodiscard]] Decomposition : private Outcome<Expression>
+{
+    static constexpr bool owning = owns_operands<Expression>::value;
+
     const char * const code;
-    const Expression expression;
-    const bool value;
+    typename ::std::conditional<owns_operands<Expression>::value, Expression, const Expression>::type expression;
 
-    constexpr Decomposition(const char * s, const Expression & x, bool v) : code(s), expression(x), value(v) { }
+    constexpr Decomposition(const char * s, const Expression & x, bool v) : Outcome<Expression>(v), code(s), expression(x) { }
+    constexpr Decomposition(const char * s, Expression && x, bool v) : Outcome<Expression>(v), code(s), expression(::std::move(x)) { }
     Decomposition() = delete;
+    Decomposition(const Decomposition &) = default;
+    Decomposition(Decomposition &&) = default;
     ~Decomposition() = default;
 
     friend ::std::ostream & operator<<(::std::ostream & os, const Decomposition & this_)
     {
         // Printing to local stream avoids involuntary manipulation of the std::ostream.
         ::std::stringstream stream;
-        stream << ::std::boolalpha << "verify(" << this_.code << ") => verify(" << this_.expression << ") => " << this_.value;
+        const char * const name = macro_name<Expression>::value;
+        stream << ::std::boolalpha << name << '(' << this_.code << ") => " << name << '(' << this_.expression << ") => " << this_.value();
         return os << stream.str();
     }
 
-    constexpr auto operator!() const { return NegatedDecomposition<Expression>(code, expression, value); }
+    constexpr auto operator!() const & { return NegatedDecomposition<Expression>(code, expression, value()); }
+    constexpr auto operator!() &&
+    {
+        const bool v = value();
+        return NegatedDecomposition<Expression>(code, ::std::move(expression), v);
+    }
 
-    constexpr operator bool() const { return value; }
+    /// The result of the expression itself (i.e. not negated by a `NegatedDecomposition`).
+    constexpr bool value() const { return this->of(expression); }
+
+    constexpr operator bool() const { return value(); }
 };
 
-template<class E> constexpr auto make_decomposition(const char * code, const E & x)
+template<class E> constexpr auto make_decomposition(const char * code, E && x)
 {
-    return Decomposition<E>(code, x, x.evaluate());
+    const bool value = x.evaluate();
+    return Decomposition<typename ::std::decay<E>::type>(code, ::std::forward<E>(x), value);
 }
 
 
@@ -136,30 +1275,308 @@ template<class Expression> struct [[nodiscard]] NegatedDecomposition : public De
     using Decomposition<Expression>::value;
 
     constexpr NegatedDecomposition(const char * s, const Expression & x, bool v) : Decomposition<Expression>(s,x,v) { }
+    constexpr NegatedDecomposition(const char * s, Expression && x, bool v) : Decomposition<Expression>(s, ::std::move(x), v) { }
     NegatedDecomposition() = delete;
+    NegatedDecomposition(const NegatedDecomposition &) = default;
+    NegatedDecomposition(NegatedDecomposition &&) = default;
     ~NegatedDecomposition() = default;
 
     friend ::std::ostream & operator<<(::std::ostream & os, const NegatedDecomposition & this_)
     {
         // Printing to local stream avoids involuntary manipulation of the std::ostream.
-        const bool value = ! this_.value;
+        const bool value = ! this_.value();
         ::std::stringstream stream;
-        stream << ::std::boolalpha << "!verify(" << this_.code << ") => !verify(" << this_.expression << ") => " << value;
+        const char * const name = macro_name<Expression>::value;
+        stream << ::std::boolalpha << '!' << name << '(' << this_.code << ") => !" << name << '(' << this_.expression << ") => " << value;
         return os << stream.str();
     }
 
-    constexpr auto operator!() const { return Decomposition<Expression>(code, expression, value); }
+    constexpr auto operator!() const & { return Decomposition<Expression>(code, expression, value()); }
+    constexpr auto operator!() &&
+    {
+        const bool v = value();
+        return Decomposition<Expression>(code, ::std::move(expression), v);
+    }
+
+    constexpr operator bool() const { return !value(); }
+};
+
+#endif // CPP_VERIFY_DECOMPOSE
+
+
+struct NegatedCondition;
+
+
+struct [[nodiscard]] Condition
+{
+    const char * const code;
+    const bool value;
+
+    constexpr Condition(const char * s, bool v) : code(s), value(v) { }
+    Condition() = delete;
+    ~Condition() = default;
+
+    friend ::std::ostream & operator<<(::std::ostream & os, const Condition & this_)
+    {
+        // Printing the result as text (instead of via std::boolalpha) avoids involuntary manipulation of the std::ostream.
+        return os << "verify(" << this_.code << ") => " << (this_.value ? "true" : "false");
+    }
+
+    constexpr NegatedCondition operator!() const;
+
+    constexpr operator bool() const { return value; }
+};
+
+
+struct [[nodiscard]] NegatedCondition : public Condition
+{
+    constexpr NegatedCondition(const char * s, bool v) : Condition(s,v) { }
+    NegatedCondition() = delete;
+    ~NegatedCondition() = default;
+
+    friend ::std::ostream & operator<<(::std::ostream & os, const NegatedCondition & this_)
+    {
+        // Printing the result as text (instead of via std::boolalpha) avoids involuntary manipulation of the std::ostream.
+        return os << "!verify(" << this_.code << ") => " << (this_.value ? "false" : "true");
+    }
+
+    constexpr Condition operator!() const { return Condition(code, value); }
 
     constexpr operator bool() const { return !value; }
 };
 
+constexpr NegatedCondition Condition::operator!() const { return NegatedCondition(code, value); }
+
+
+//////
+// == Aggregation via && and || ==
+//
+// The built-in `operator&&` and `operator||` short-circuit, overloaded ones don't: both of their operands are evaluated before the call.
+// Therefore, the right-hand side is wrapped into a `Deferred` (by `verify_lazily(x)`), which is only evaluated if necessary.
+// The `Junction` then keeps the left-hand side and -- if it got evaluated -- the right-hand side.
+// Temporaries of the right-hand side die with the `Deferred`'s call, so they are moved into its result (see `verify_owned()`).
+
+#define verify_lazily(x) \
+    (CppVerify::defer(#x, [&]() { return verify_owned(x); }))
+
+struct AND { static constexpr bool short_circuits(bool lhs) { return !lhs; } };
+struct OR  { static constexpr bool short_circuits(bool lhs) { return  lhs; } };
+
+inline ::std::ostream & operator<<(::std::ostream & os, const AND) { return os << " && "; }
+inline ::std::ostream & operator<<(::std::ostream & os, const OR)  { return os << " || "; }
+
+
+template<typename F> struct Deferred
+{
+    const char * const code;
+    const F evaluate;
+
+    constexpr Deferred(const char * s, const F & f) : code(s), evaluate(f) { }
+    Deferred() = delete;
+    ~Deferred() = default;
+};
+
+template<typename F> constexpr auto defer(const char * code, const F & f) { return Deferred<F>(code, f); }
+
+
+template<class Connective, class L, class R> struct NegatedJunction;
+
+
+template<class Connective, class L, class R> struct [[nodiscard]] Junction
+{
+    static constexpr bool owning = owns_operands<L>::value || owns_operands<R>::value;
+
+    typename ::std::conditional<owns_operands<L>::value, L, const L>::type lhs;
+    const char * const rhs_code;
+    typename ::std::conditional<owns_operands<R>::value, ::std::optional<R>, const ::std::optional<R>>::type rhs; ///< Empty, if `lhs` alone decided the result.
+    const bool value;
+
+    constexpr Junction(L l, const char * code, ::std::optional<R> r, bool v) : lhs(::std::move(l)), rhs_code(code), rhs(::std::move(r)), value(v) { }
+    Junction() = delete;
+    Junction(const Junction &) = default;
+    Junction(Junction &&) = default;
+    ~Junction() = default;
+
+    friend ::std::ostream & operator<<(::std::ostream & os, const Junction & this_)
+    {
+        // The operands print themselves without manipulating the std::ostream, and so does the result, as text.
+        this_.print_operands(os);
+        return os << " => " << (this_.value ? "true" : "false");
+    }
+
+    constexpr auto operator!() const { return NegatedJunction<Connective, L, R>(lhs, rhs_code, rhs, value); }
+
+    constexpr operator bool() const { return value; }
+
+protected:
+    void print_operands(::std::ostream & stream) const
+    {
+        stream << '(' << lhs << ')' << Connective() << '(';
+        if(rhs)
+            stream << *rhs;
+        else
+            stream << "verify(" << rhs_code << ") => not evaluated";
+        stream << ')';
+    }
+};
+
+
+template<class Connective, class L, class R> struct [[nodiscard]] NegatedJunction : public Junction<Connective, L, R>
+{
+    using Junction<Connective, L, R>::lhs;
+    using Junction<Connective, L, R>::rhs_code;
+    using Junction<Connective, L, R>::rhs;
+    using Junction<Connective, L, R>::value;
+
+    constexpr NegatedJunction(L l, const char * code, ::std::optional<R> r, bool v) : Junction<Connective, L, R>(::std::move(l), code, ::std::move(r), v) { }
+    NegatedJunction() = delete;
+    NegatedJunction(const NegatedJunction &) = default;
+    NegatedJunction(NegatedJunction &&) = default;
+    ~NegatedJunction() = default;
+
+    friend ::std::ostream & operator<<(::std::ostream & os, const NegatedJunction & this_)
+    {
+        // The operands print themselves without manipulating the std::ostream, and so does the result, as text.
+        os << "!(";
+        this_.print_operands(os);
+        return os << ") => " << (this_.value ? "false" : "true");
+    }
+
+    constexpr auto operator!() const { return Junction<Connective, L, R>(lhs, rhs_code, rhs, value); }
+
+    constexpr operator bool() const { return !value; }
+};
+
+
+/// Only results of verify() (and aggregations thereof) take part in aggregation.
+template<typename T> struct is_result : ::std::false_type { };
+template<> struct is_result<Condition> : ::std::true_type { };
+template<> struct is_result<NegatedCondition> : ::std::true_type { };
+#if CPP_VERIFY_DECOMPOSE
+template<typename E> struct is_result<Decomposition<E>> : ::std::true_type { };
+template<typename E> struct is_result<NegatedDecomposition<E>> : ::std::true_type { };
+#endif
+template<class C, class L, class R> struct is_result<Junction<C, L, R>> : ::std::true_type { };
+template<class C, class L, class R> struct is_result<NegatedJunction<C, L, R>> : ::std::true_type { };
+
+/// Both sides are moved into the `Junction`, if they are rvalues that own their operands.
+template<typename Connective, typename L, typename F> constexpr auto make_junction(L && lhs, const Deferred<F> & rhs)
+{
+    using Lhs = typename ::std::decay<L>::type;
+    using R = decltype(rhs.evaluate());
+
+    const bool value = static_cast<bool>(lhs);
+    if(Connective::short_circuits(value))
+        return Junction<Connective, Lhs, R>(::std::forward<L>(lhs), rhs.code, ::std::nullopt, value);
+
+    ::std::optional<R> result = rhs.evaluate();
+    const bool v = static_cast<bool>(*result);
+    return Junction<Connective, Lhs, R>(::std::forward<L>(lhs), rhs.code, ::std::move(result), v);
+}
+
+template<typename L, typename F, typename = typename ::std::enable_if<is_result<typename ::std::decay<L>::type>::value>::type>
+constexpr auto operator&&(L && lhs, const Deferred<F> & rhs) { return make_junction<AND>(::std::forward<L>(lhs), rhs); }
+
+template<typename L, typename F, typename = typename ::std::enable_if<is_result<typename ::std::decay<L>::type>::value>::type>
+constexpr auto operator||(L && lhs, const Deferred<F> & rhs) { return make_junction<OR>(::std::forward<L>(lhs), rhs); }
+
+
+#if CPP_VERIFY_DECOMPOSE
+
+/// Operands are captured by value if that is cheap, i.e. if they are trivially copyable and fit into two machine words.
+/// Thus, the result does not refer to (possibly dead) temporaries, and scalars need not live in memory.
+/// All other operands are captured by reference.
+template<typename T> struct Capture
+{
+    static constexpr bool by_value = ::std::is_trivially_copyable<T>::value && !::std::is_array<T>::value && (sizeof(T) <= 2 * sizeof(void *));
+
+    using type = typename ::std::conditional<by_value, const typename ::std::remove_cv<T>::type, const T &>::type;
+    using argument = const T &;     ///< How the operand is handed to the expression.
+    using operand = T;              ///< The type of the operand, as compared.
+};
+
+/// Rvalue operands of `verify_owned()` that are too large to be captured by value, moved into the result.
+template<typename T> struct Owned;
+
+template<typename T> struct Capture<Owned<T>>
+{
+    static constexpr bool by_value = true;
+
+    using type = T;
+    using argument = T &&;
+    using operand = T;
+};
+
+template<typename T> using captured_t = typename Capture<T>::type;
+template<typename T> using argument_t = typename Capture<T>::argument;
+template<typename T> using operand_t = typename Capture<T>::operand;
+
+template<typename T> struct is_owned : ::std::false_type { };
+template<typename T> struct is_owned<Owned<T>> : ::std::true_type { };
+
+
+#ifndef CPP_VERIFY_ATOMIC_MEMORY_ORDER
+    #define CPP_VERIFY_ATOMIC_MEMORY_ORDER ::std::memory_order_relaxed
+#endif
+
+/// Atomic (and volatile) operands are read exactly once, into a snapshot that is both evaluated and printed.
+/// Atomics are loaded with `CPP_VERIFY_ATOMIC_MEMORY_ORDER` (`std::memory_order_relaxed` by default),
+/// volatile scalars are copied (like any other small operand, see `Capture`).
+template<typename T> struct Snapshot
+{
+    using type = T;
+
+    static constexpr const T & take(const T & operand) { return operand; }
+};
+
+template<typename T> struct Snapshot<volatile T>
+{
+    static_assert(::std::is_scalar<T>::value, "verify() reads volatile scalars only.");
+    using type = T;
+
+    static constexpr T take(const volatile T & operand) { return operand; }
+};
+
+template<typename T> struct Snapshot<::std::atomic<T>>
+{
+    static_assert(Capture<T>::by_value, "verify() snapshots atomics of trivially copyable values that fit into two machine words.");
+    using type = T;
+
+    static T take(const ::std::atomic<T> & operand) { return operand.load(CPP_VERIFY_ATOMIC_MEMORY_ORDER); }
+};
+
+template<typename T> struct Snapshot<Owned<T>>
+{
+    using type = Owned<T>;
+
+    static constexpr T && take(T && operand) { return static_cast<T &&>(operand); }
+};
+
+template<typename T> using snapshot_t = typename Snapshot<T>::type;
+
+
+/// `verify_owned()` takes ownership of rvalue operands, unless they are captured by value (or snapshot) anyway.
+template<typename T> using owned_t = typename ::std::conditional<
+    !Capture<T>::by_value && ::std::is_same<snapshot_t<T>, T>::value, Owned<T>, T>::type;
+
+template<typename T> struct is_within : ::std::false_type { };
+template<typename Tolerance, typename T, typename M> struct is_within<Within<Tolerance, T, M>> : ::std::true_type { };
+
+/// Rvalues whose ownership `verify_owned()` may take: neither const (so they can be moved from) nor tolerances (which select the comparison).
+template<typename T> struct is_movable_operand
+    : ::std::integral_constant<bool, !::std::is_reference<T>::value && !::std::is_const<T>::value && !is_within<T>::value> { };
+
 
 template<typename T> struct UnaryExpression
 {
-    const T & operand;
+    static constexpr bool owning = is_owned<T>::value;
+
+    captured_t<T> operand;
 
-    constexpr explicit UnaryExpression(const T & op) : operand(op) { }
+    constexpr explicit UnaryExpression(argument_t<T> op) : operand(::std::forward<argument_t<T>>(op)) { }
     UnaryExpression() = delete;
+    UnaryExpression(const UnaryExpression &) = default;
+    UnaryExpression(UnaryExpression &&) = default;
     ~UnaryExpression() = default;
 
     constexpr bool evaluate() const { return static_cast<bool>(operand); }
@@ -174,73 +1591,202 @@ template<typename T> struct UnaryExpression
 };
 
 
+#if CPP_VERIFY__THREE_WAY
+
+struct NoOrdering { };
+
+/// By default, a comparison is evaluated directly, just like the language does (e.g. via a class type's own `operator<`,
+/// or else via its `<=>`, called once), and no ordering is kept.
+template<typename L, typename Comparison, typename R, typename = void> struct Ordering
+{
+    using type = NoOrdering;
+
+    static constexpr type compare(const L &, const R &) { return {}; }
+    static constexpr bool evaluate(const L & op1, const R & op2, type) { return Comparison::evaluate(op1, op2); }
+};
+
+/// `verify(a <=> b)` keeps the result of `<=>`, which is printed, and holds if it isn't unordered.
+template<typename L, typename R>
+struct Ordering<L, SPACESHIP, R, typename ::std::enable_if<!is_ordering<L>::value>::type>
+{
+    using type = ::std::compare_three_way_result_t<L, R>;
+
+    static constexpr type compare(const L & op1, const R & op2) { return (op1 <=> op2); }
+    static constexpr bool evaluate(const L &, const R &, type ordering) { return FromOrdering<SPACESHIP>::evaluate(ordering); }
+};
+
+/// An ordering (e.g. from `verify((a <=> b) == 0)`) may only be compared against the literal `0`.
+template<typename L, typename Comparison, typename R>
+struct Ordering<L, Comparison, R, typename ::std::enable_if<is_ordering<L>::value && ::std::is_integral<R>::value>::type>
+{
+    using type = NoOrdering;
+
+    static constexpr type compare(const L &, const R &) { return {}; }
+    static constexpr bool evaluate(const L & op1, const R & op2, type) { return (op2 == 0) && FromOrdering<Comparison>::evaluate(op1); }
+};
+
+#endif // CPP_VERIFY__THREE_WAY
+
+
 template<typename L, typename Comparison, typename R> struct BinaryExpression
 {
-    const L & operand1;
-    const R & operand2;
+    static constexpr bool owning = is_owned<L>::value || is_owned<R>::value;
+
+    captured_t<L> operand1;
+    captured_t<R> operand2;
+#if CPP_VERIFY__THREE_WAY
+    using Order = Ordering<operand_t<L>, Comparison, operand_t<R>>;
 
-    constexpr BinaryExpression(const L & op1, const R & op2) : operand1(op1), operand2(op2) { }
+    [[no_unique_address]] const typename Order::type ordering; ///< The result of `verify(a <=> b)`.
+
+    constexpr BinaryExpression(argument_t<L> op1, argument_t<R> op2)
+        : operand1(::std::forward<argument_t<L>>(op1)), operand2(::std::forward<argument_t<R>>(op2)), ordering(Order::compare(operand1, operand2))
+    { }
+#else
+    constexpr BinaryExpression(argument_t<L> op1, argument_t<R> op2) : operand1(::std::forward<argument_t<L>>(op1)), operand2(::std::forward<argument_t<R>>(op2)) { }
+#endif
     BinaryExpression() = delete;
+    BinaryExpression(const BinaryExpression &) = default;
+    BinaryExpression(BinaryExpression &&) = default;
     ~BinaryExpression() = default;
 
+#if CPP_VERIFY__THREE_WAY
+    constexpr bool evaluate() const { return Order::evaluate(operand1, operand2, ordering); }
+#else
     constexpr bool evaluate() const { return Comparison::evaluate(operand1, operand2); }
+#endif
 
     friend ::std::ostream & operator<<(::std::ostream & os, const BinaryExpression & this_)
     {
         // Printing to local stream avoids involuntary manipulation of the std::ostream.
         ::std::stringstream stream;
-        stream << this_.operand1 << Comparison() << this_.operand2;
+#if CPP_VERIFY__THREE_WAY
+        if constexpr(::std::is_same<Comparison, SPACESHIP>::value)
+        {
+            stream << '(';
+            print(stream, this_.operand1);
+            stream << Comparison();
+            print(stream, this_.operand2);
+            stream << ") == " << this_.ordering;
+        }
+        else
+#endif
+        explain(stream, this_.operand1, Comparison(), this_.operand2, TopRank());
         return os << stream.str();
     }
 };
 
 
-struct decompose
+template<typename> struct always_false : ::std::false_type { };
+
+#define CPP_VERIFY__REJECT_LOGICAL_OPERATORS \
+    template<typename Other> constexpr auto operator&&(const Other &) const \
+    { \
+        static_assert(always_false<Other>::value, "verify(a && b) can't keep short-circuit evaluation; write verify(a) && verify_lazily(b) instead."); \
+        return false; \
+    } \
+    template<typename Other> constexpr auto operator||(const Other &) const \
+    { \
+        static_assert(always_false<Other>::value, "verify(a || b) can't keep short-circuit evaluation; write verify(a) || verify_lazily(b) instead."); \
+        return false; \
+    }
+
+
+/// `verify()` refers to its operands, unless they are small (see `Capture`).
+/// `verify_owned()` moves rvalue operands into its result instead, while still referring to lvalues.
+/// Which of both happens is decided at compile time, by overloads for (non-const) rvalues, that `verify()` doesn't enable.
+template<bool owning> struct basic_decompose
 {
     const char * const code;
 
-    decompose() = delete;
-    constexpr explicit decompose(const char * code) : code(code) { }
-    ~decompose() = default;
+    basic_decompose() = delete;
+    constexpr explicit basic_decompose(const char * code) : code(code) { }
+    ~basic_decompose() = default;
 
     template<typename T1> struct FirstOperand
     {
         const char * const code;
-        const T1 & operand1;
+        argument_t<T1> operand1;
 
         FirstOperand() = delete;
-        constexpr FirstOperand(const char * code, const T1 & op1) : code(code), operand1(op1) { }
+        constexpr FirstOperand(const char * code, argument_t<T1> op1) : code(code), operand1(::std::forward<argument_t<T1>>(op1)) { }
         ~FirstOperand() = default;
 
-        constexpr auto finish() const { return make_decomposition(code, UnaryExpression<T1>(operand1)); }
+        constexpr auto finish() const
+        {
+            return make_decomposition(code, UnaryExpression<snapshot_t<T1>>(Snapshot<T1>::take(::std::forward<argument_t<T1>>(operand1))));
+        }
 
 
         template<typename C, typename T2> struct SecondOperand
         {
             const char * const code;
-            const T1 & operand1;
-            const T2 & operand2;
+            argument_t<T1> operand1;
+            argument_t<T2> operand2;
 
             SecondOperand() = delete;
-            constexpr SecondOperand(const char * code, const T1 & op1, const T2 & op2)
-                : code(code), operand1(op1), operand2(op2)
+            constexpr SecondOperand(const char * code, argument_t<T1> op1, argument_t<T2> op2)
+                : code(code), operand1(::std::forward<argument_t<T1>>(op1)), operand2(::std::forward<argument_t<T2>>(op2))
             { }
             ~SecondOperand() = default;
 
-            constexpr auto finish() const { return make_decomposition(code, BinaryExpression<T1,C,T2>(operand1,operand2)); }
+            constexpr auto finish() const
+            {
+                return make_decomposition(code, BinaryExpression<snapshot_t<T1>,C,snapshot_t<T2>>(
+                    Snapshot<T1>::take(::std::forward<argument_t<T1>>(operand1)), Snapshot<T2>::take(::std::forward<argument_t<T2>>(operand2))));
+            }
+
+            CPP_VERIFY__REJECT_LOGICAL_OPERATORS
         };
 
-        template<typename T2> constexpr auto operator==(const T2 & op2) { return SecondOperand<EQ,T2>(code, operand1, op2); }
-        template<typename T2> constexpr auto operator!=(const T2 & op2) { return SecondOperand<NE,T2>(code, operand1, op2); }
-        template<typename T2> constexpr auto operator<=(const T2 & op2) { return SecondOperand<LE,T2>(code, operand1, op2); }
-        template<typename T2> constexpr auto operator>=(const T2 & op2) { return SecondOperand<GE,T2>(code, operand1, op2); }
-        template<typename T2> constexpr auto operator< (const T2 & op2) { return SecondOperand<LT,T2>(code, operand1, op2); }
-        template<typename T2> constexpr auto operator> (const T2 & op2) { return SecondOperand<GT,T2>(code, operand1, op2); }
+#define CPP_VERIFY__COMPARISON(op, C) \
+        template<typename T2> constexpr auto operator op(const T2 & op2) \
+        { \
+            return SecondOperand<C,T2>(code, ::std::forward<argument_t<T1>>(operand1), op2); \
+        } \
+        template<typename T2, typename = typename ::std::enable_if<owning && is_movable_operand<T2>::value>::type> constexpr auto operator op(T2 && op2) \
+        { \
+            return SecondOperand<C,owned_t<T2>>(code, ::std::forward<argument_t<T1>>(operand1), ::std::move(op2)); \
+        }
+
+        CPP_VERIFY__COMPARISON(==, EQ)
+        CPP_VERIFY__COMPARISON(!=, NE)
+        CPP_VERIFY__COMPARISON(<=, LE)
+        CPP_VERIFY__COMPARISON(>=, GE)
+        CPP_VERIFY__COMPARISON(<,  LT)
+        CPP_VERIFY__COMPARISON(>,  GT)
+
+        template<typename Tolerance, typename T, typename M> constexpr auto operator==(const Within<Tolerance, T, M> & op2)
+        {
+            return SecondOperand<Tolerance, Within<Tolerance, T, M>>(code, ::std::forward<argument_t<T1>>(operand1), op2);
+        }
+        template<typename Tolerance, typename T, typename M> constexpr auto operator!=(const Within<Tolerance, T, M> & op2)
+        {
+            return SecondOperand<NE, Within<Tolerance, T, M>>(code, ::std::forward<argument_t<T1>>(operand1), op2);
+        }
+#if CPP_VERIFY__THREE_WAY
+        CPP_VERIFY__COMPARISON(<=>, SPACESHIP)
+#endif
+
+#undef CPP_VERIFY__COMPARISON
+
+        CPP_VERIFY__REJECT_LOGICAL_OPERATORS
     };
 
     template<typename T> constexpr auto operator<<(const T & op1) const { return FirstOperand<T>(code, op1); }
+
+    template<typename T, typename = typename ::std::enable_if<owning && is_movable_operand<T>::value>::type> constexpr auto operator<<(T && op1) const
+    {
+        return FirstOperand<owned_t<T>>(code, ::std::move(op1));
+    }
 };
 
+using decompose = basic_decompose<false>;
+using decompose_owned = basic_decompose<true>;
+
+#undef CPP_VERIFY__REJECT_LOGICAL_OPERATORS
+
+#endif // CPP_VERIFY_DECOMPOSE
 
 }
 
@@ -0,0 +1,148 @@
+//////
+/// \file     verify-all.test.cpp
+/// \brief    Test the verify_all() functionality.
+///
+/// \details  Every available instruction set (down to the scalar fallback) must yield the same results,
+///           in particular for the tails (lengths that are no multiple of the vector width) and for NaN.
+//////
+
+#include <verify-all.hpp> // DUT
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "pretty-file.h"
+
+#define DOCTEST_CONFIG_VOID_CAST_EXPRESSIONS
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+namespace {
+
+    using CppVerify::Kernels::Isa;
+
+    /// Run `check` once per instruction set, from the best supported one down to the scalar fallback.
+    template<typename F> void for_each_isa(F check)
+    {
+        const Isa selected = CppVerify::Kernels::isa();
+        for(int i = static_cast<int>(CppVerify::Kernels::detected_isa()); i >= 0; --i)
+        {
+            CppVerify::Kernels::isa() = static_cast<Isa>(i);
+            check();
+        }
+        CppVerify::Kernels::isa() = selected;
+    }
+
+    /// Each position of a single failure, in arrays around the sizes of the vector blocks.
+    template<typename T> void check_single_failures()
+    {
+        for(std::size_t n : {0, 1, 7, 16, 63, 64, 65, 255, 256, 257, 1000})
+        {
+            std::vector<T> x(n, T(1));
+            CHECK(verify_all(x, ==, T(1)));
+            CHECK(verify_all(x, >=, 1));
+            CHECK(verify_all(x, ==, x));
+
+            for(std::size_t i = 0; i < n; i += 1 + (i / 4))
+            {
+                x[i] = T(0);
+                const auto result = verify_all(x, >, T(0));
+                CHECK_FALSE(result);
+#if CPP_VERIFY_DECOMPOSE
+                CHECK(result.expression.first == i);
+                CHECK(result.expression.failures == 1u);
+#endif
+                x[i] = T(1);
+            }
+        }
+    }
+
+}
+
+TEST_SUITE(__PRETTY_FILE__)
+{
+    TEST_CASE("verify_all() against a value")
+    {
+        const std::vector<int> prices = {3, 1, 4, 1, 5, 9, 2, 6};
+
+        CHECK(verify_all(prices, >=, 0));
+        CHECK(verify_all(prices, <, 10));
+        CHECK(verify_all(prices, !=, 7));
+        CHECK_FALSE(verify_all(prices, >, 1));
+        CHECK_FALSE(verify_all(prices, ==, 3));
+        CHECK(!verify_all(prices, <=, 8));
+
+        const int empty[1] = {0};
+        CHECK(verify_all(empty, ==, 0));
+    }
+
+    TEST_CASE("verify_all() against another array")
+    {
+        const std::array<double, 5> a = {1.0, 2.0, 3.0, 4.0, 5.0};
+        const std::vector<double> b = {1.0, 2.0, 3.5, 4.0, 4.5};
+        const std::vector<float> c = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f};
+
+        CHECK(verify_all(a, ==, a));
+        CHECK(verify_all(a, <=, b) == false);
+        CHECK(verify_all(a, ==, c));
+        CHECK_FALSE(verify_all(a, ==, b));
+        CHECK_FALSE(verify_all(b, ==, std::vector<double>(b.begin(), b.end() - 1)));
+    }
+
+    TEST_CASE("verify_all() with every instruction set")
+    {
+        for_each_isa([] {
+            check_single_failures<std::int8_t>();
+            check_single_failures<std::uint16_t>();
+            check_single_failures<int>();
+            check_single_failures<std::int64_t>();
+            check_single_failures<float>();
+            check_single_failures<double>();
+        });
+    }
+
+    TEST_CASE("verify_all() with NaN")
+    {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        for_each_isa([nan] {
+            std::vector<double> x(100, 0.5);
+            x[42] = nan;
+            CHECK_FALSE(verify_all(x, >=, 0.0));
+            CHECK_FALSE(verify_all(x, ==, x));
+            CHECK(verify_all(x, !=, 1.0));
+
+            // A float array against a double value, that float represents exactly (broadcast), and inexactly (compared one by one).
+            std::vector<float> y(100, 0.1f);
+            CHECK(verify_all(y, <, 0.5));
+            CHECK(verify_all(y, >, 0.1));
+            CHECK(verify_all(y, ==, 0.1f));
+        });
+    }
+
+    TEST_CASE("verify_all() of non-arithmetic elements")
+    {
+        const std::vector<std::string> names = {"abc", "abd", "abe"};
+        CHECK(verify_all(names, >, "ab"));
+        CHECK(verify_all(names, <, std::string("b")));
+        CHECK_FALSE(verify_all(names, ==, names[0]));
+    }
+
+#if CPP_VERIFY_DECOMPOSE
+    TEST_CASE("verify_all() printing")
+    {
+        const std::vector<int> prices = {3, -1, 4, -1, 5};
+        const std::vector<int> fewer = {3, 1, 4};
+
+        std::stringstream os;
+        os << verify_all(prices, >=, -1) << '\n' << verify_all(prices, >=, 0) << '\n' << !verify_all(prices, ==, fewer);
+        CHECK(os.str() == "verify_all(prices >= -1) => verify_all(5 of 5 elements pass) => true\n"
+                          "verify_all(prices >= 0) => verify_all([1]: -1 >= 0; 2 of 5 elements fail) => false\n"
+                          "!verify_all(prices == fewer) => !verify_all([1]: -1 == 1; sizes differ: 5 != 3; 3 of 5 elements fail) => true");
+    }
+#endif
+}
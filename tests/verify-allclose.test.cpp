@@ -0,0 +1,178 @@
+//////
+/// \file     verify-allclose.test.cpp
+/// \brief    Test the verify_allclose() functionality.
+///
+/// \details  Every available instruction set (down to the scalar fallback) must yield the same statistics,
+///           in particular for the tails (lengths that are no multiple of the vector width), NaN and infinities.
+//////
+
+#include <verify-allclose.hpp> // DUT
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "pretty-file.h"
+
+#define DOCTEST_CONFIG_VOID_CAST_EXPRESSIONS
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+namespace {
+
+    using CppVerify::Kernels::Isa;
+
+    /// Run `check` once per instruction set, from the best supported one down to the scalar fallback.
+    template<typename F> void for_each_isa(F check)
+    {
+        const Isa selected = CppVerify::Kernels::isa();
+        for(int i = static_cast<int>(CppVerify::Kernels::detected_isa()); i >= 0; --i)
+        {
+            CppVerify::Kernels::isa() = static_cast<Isa>(i);
+            check();
+        }
+        CppVerify::Kernels::isa() = selected;
+    }
+
+    /// Perturb some elements well beyond the tolerance (and all others well within it), and compare the statistics to a plain loop.
+    template<typename T> void check_statistics()
+    {
+        std::mt19937 random(7);
+        for(std::size_t n : {0, 1, 7, 16, 31, 64, 65, 257, 1000})
+        {
+            std::vector<T> expected(n);
+            for(T & x : expected)
+                x = static_cast<T>(std::uniform_real_distribution<double>(-100.0, 100.0)(random));
+            std::vector<T> actual = expected;
+            for(std::size_t i = 0; i < n; i += 1 + i / 3)
+                actual[i] = expected[i] * static_cast<T>(1 + ((i % 5 == 0) ? 1e-2 : 1e-7));
+
+            T max_absolute = 0;
+            T max_relative = 0;
+            std::size_t worst = n;
+            bool worst_fails = false;
+            T worst_error = 0;
+            std::size_t failures = 0;
+            for(std::size_t i = 0; i < n; ++i)
+            {
+                const T error = std::abs(actual[i] - expected[i]);
+                const bool fails = !(error <= static_cast<T>(1e-8) + static_cast<T>(1e-5) * std::abs(expected[i]));
+                failures += fails;
+                if(error > max_absolute)
+                    max_absolute = error;
+                // Failing elements are worse than passing ones, whatever their error.
+                if((fails && !worst_fails) || (fails == worst_fails && error > worst_error))
+                    worst = i, worst_fails = fails, worst_error = error;
+                if(error / std::abs(expected[i]) > max_relative)
+                    max_relative = error / std::abs(expected[i]);
+            }
+
+            const auto result = verify_allclose(actual, expected);
+            CHECK(static_cast<bool>(result) == (failures == 0));
+            CHECK(static_cast<bool>(verify_allclose(expected, expected)));
+#if CPP_VERIFY_DECOMPOSE
+            CHECK(result.expression.closeness.failures == failures);
+            CHECK(result.expression.closeness.worst == worst);
+            CHECK(result.expression.closeness.max_absolute == max_absolute);
+            CHECK(result.expression.closeness.max_relative == max_relative);
+#else
+            static_cast<void>(worst);
+#endif
+        }
+    }
+
+}
+
+TEST_SUITE(__PRETTY_FILE__)
+{
+    TEST_CASE("verify_allclose()")
+    {
+        const std::vector<double> a = {1.0, 2.0, 3.0};
+        const std::vector<double> b = {1.0, 2.0 + 1e-9, 3.0 - 1e-6};
+        const std::array<double, 2> fewer = {1.0, 2.0};
+
+        CHECK(verify_allclose(a, a));
+        CHECK(verify_allclose(a, b));
+        CHECK_FALSE(verify_allclose(a, b, 1e-9, 1e-9));
+        CHECK(verify_allclose(a, b, 0.0, 1e-5));
+        CHECK(!verify_allclose(a, fewer));
+        CHECK(!verify_allclose(fewer, a));
+    }
+
+    TEST_CASE("verify_allclose() with every instruction set")
+    {
+        for_each_isa([] {
+            check_statistics<float>();
+            check_statistics<double>();
+        });
+    }
+
+    TEST_CASE("verify_allclose() with NaN and infinities")
+    {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        const double inf = std::numeric_limits<double>::infinity();
+        for_each_isa([=] {
+            std::vector<double> x(100, 1.0);
+            x[10] = inf;
+            x[20] = -inf;
+            CHECK(verify_allclose(x, x));
+
+            std::vector<double> y = x;
+            y[10] = -inf;
+            y[50] = nan;
+            y[70] = 1.5;
+            const auto result = verify_allclose(x, y);
+            CHECK_FALSE(result);
+#if CPP_VERIFY_DECOMPOSE
+            CHECK(result.expression.closeness.failures == 3u);
+            CHECK(result.expression.closeness.worst == 50u);
+#endif
+        });
+    }
+
+    TEST_CASE("verify_allclose() failing by NaN only")
+    {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        for_each_isa([=] {
+            // The passing elements have larger errors than any other, but the worst element is the failing one.
+            std::vector<double> x(100, 1.0);
+            std::vector<double> y(100, 1.0);
+            for(std::size_t i = 0; i < y.size(); i += 3)
+                y[i] = 1.000001;
+            x[70] = nan;
+            const auto result = verify_allclose(x, y);
+            CHECK_FALSE(result);
+#if CPP_VERIFY_DECOMPOSE
+            CHECK(result.expression.closeness.failures == 1u);
+            CHECK(result.expression.closeness.worst == 70u);
+#endif
+        });
+    }
+
+#if CPP_VERIFY_DECOMPOSE
+    TEST_CASE("verify_allclose() printing")
+    {
+        std::vector<float> output(1000, 1.5f);
+        const std::vector<float> expected(1000, 1.5f);
+        const std::vector<double> fewer = {1.0, 2.0};
+        const std::vector<double> more = {1.0, 2.0, 3.0};
+
+        std::stringstream os;
+        os << verify_allclose(output, expected) << '\n';
+        output[17] = 1.75f;
+        output[3] = 1.5000001f;
+        os << verify_allclose(output, expected, 1e-5, 1e-8) << '\n' << !verify_allclose(fewer, more);
+        const std::vector<double> a = {1.0, 2.0, std::numeric_limits<double>::quiet_NaN(), 4.0};
+        const std::vector<double> b = {1.0, 2.000001, 3.0, 4.0};
+        os << '\n' << verify_allclose(a, b);
+        CHECK(os.str() == "verify_allclose(output, expected) => verify_allclose(1000 of 1000 elements close (rtol 1e-05, atol 1e-08; max absolute error 0, max relative error 0)) => true\n"
+                          "verify_allclose(output, expected, 1e-5, 1e-8) => verify_allclose(worst [17]: 1.75 vs. 1.5; 1 of 1000 elements not close (rtol 1e-05, atol 1e-08; max absolute error 0.25, max relative error 0.166667)) => false\n"
+                          "!verify_allclose(fewer, more) => !verify_allclose(sizes differ: 2 != 3; 1 of 3 elements not close (rtol 1e-05, atol 1e-08; max absolute error 0, max relative error 0)) => true\n"
+                          "verify_allclose(a, b) => verify_allclose(worst [2]: nan vs. 3; 1 of 4 elements not close (rtol 1e-05, atol 1e-08; max absolute error 1e-06, max relative error 5e-07)) => false");
+    }
+#endif
+}
@@ -0,0 +1,124 @@
+//////
+/// \file     verify-bytes.test.cpp
+/// \brief    Test the verify_bytes_equal() functionality.
+///
+/// \details  The first difference must be found at any offset, for every available instruction set,
+///           and the window around it must stay within the buffers.
+//////
+
+#include <verify-bytes.hpp> // DUT
+
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "pretty-file.h"
+
+#define DOCTEST_CONFIG_VOID_CAST_EXPRESSIONS
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+namespace {
+
+    using CppVerify::Kernels::Isa;
+
+    /// Run `check` once per instruction set, from the best supported one down to the scalar fallback.
+    template<typename F> void for_each_isa(F check)
+    {
+        const Isa selected = CppVerify::Kernels::isa();
+        for(int i = static_cast<int>(CppVerify::Kernels::detected_isa()); i >= 0; --i)
+        {
+            CppVerify::Kernels::isa() = static_cast<Isa>(i);
+            check();
+        }
+        CppVerify::Kernels::isa() = selected;
+    }
+
+}
+
+TEST_SUITE(__PRETTY_FILE__)
+{
+    TEST_CASE("verify_bytes_equal()")
+    {
+        const std::string sent = "Hello world!";
+        const std::string received = "Hello World!";
+
+        CHECK(verify_bytes_equal(sent.data(), sent.data(), sent.size()));
+        CHECK(verify_bytes_equal(sent.data(), received.data(), 6));
+        CHECK(verify_bytes_equal(sent.data(), received.data(), 0));
+        CHECK_FALSE(verify_bytes_equal(sent.data(), received.data(), sent.size()));
+        CHECK(!verify_bytes_equal(sent.data(), received.data(), sent.size(), CppVerify::count_mismatches));
+    }
+
+    TEST_CASE("verify_bytes_equal() with every instruction set")
+    {
+        for_each_isa([] {
+            for(std::size_t n : {1, 15, 16, 17, 63, 64, 65, 255, 256, 257, 1000})
+            {
+                // Unaligned buffers, to exercise the alignment peel as well.
+                std::vector<unsigned char> storage(n + 1, 0x5A);
+                const std::vector<unsigned char> expected(n, 0x5A);
+                unsigned char * const actual = storage.data() + 1;
+
+                CHECK(std::memcmp(actual, expected.data(), n) == 0);
+                CHECK(verify_bytes_equal(actual, expected.data(), n));
+
+                for(std::size_t i = 0; i < n; i += 1 + (i / 4))
+                {
+                    actual[i] = 0xA5;
+                    const auto result = verify_bytes_equal(actual, expected.data(), n);
+                    CHECK_FALSE(result);
+#if CPP_VERIFY_DECOMPOSE
+                    const auto & x = result.expression;
+                    CHECK(x.first == i);
+                    CHECK(x.mismatches == 0u);
+                    CHECK(x.start <= i);
+                    CHECK(i < x.start + x.length);
+                    CHECK(x.start + x.length <= n);
+                    CHECK(x.length == (n < x.window ? n : x.window));
+                    CHECK(x.actual[i - x.start] == 0xA5);
+                    CHECK(x.expected[i - x.start] == 0x5A);
+#endif
+                    actual[n - 1] = 0xA5;
+                    const auto counted = verify_bytes_equal(actual, expected.data(), n, CppVerify::count_mismatches);
+                    CHECK_FALSE(counted);
+#if CPP_VERIFY_DECOMPOSE
+                    CHECK(counted.expression.first == i);
+                    CHECK(counted.expression.mismatches == ((i == n - 1) ? 1u : 2u));
+#endif
+                    actual[n - 1] = 0x5A;
+                    actual[i] = 0x5A;
+                }
+            }
+        });
+    }
+
+#if CPP_VERIFY_DECOMPOSE
+    TEST_CASE("verify_bytes_equal() printing")
+    {
+        const std::string sent = "Hello world!";
+        const std::string received = "Hello World!";
+        const std::string line(40, '-');
+        std::string broken = line;
+        broken[38] = '\n';
+        broken[39] = '\0';
+
+        std::stringstream os;
+        os << verify_bytes_equal(sent.data(), sent.data(), sent.size()) << '\n'
+           << verify_bytes_equal(sent.data(), received.data(), sent.size()) << '\n'
+           << !verify_bytes_equal(broken.data(), line.data(), line.size(), CppVerify::count_mismatches);
+        CHECK(os.str() == "verify_bytes_equal(sent.data(), sent.data(), sent.size()) => verify_bytes_equal(12 bytes equal) => true\n"
+                          "verify_bytes_equal(sent.data(), received.data(), sent.size()) => verify_bytes_equal(first difference at offset 6 of 12 bytes\n"
+                          "  actual   @0: 48 65 6c 6c 6f 20 77 6f 72 6c 64 21  |Hello world!|\n"
+                          "  expected @0: 48 65 6c 6c 6f 20 57 6f 72 6c 64 21  |Hello World!|\n"
+                          "                                 ^^\n"
+                          ") => false\n"
+                          "!verify_bytes_equal(broken.data(), line.data(), line.size(), CppVerify::count_mismatches) => !verify_bytes_equal(first difference at offset 38 of 40 bytes (2 bytes differ)\n"
+                          "  actual   @24: 2d 2d 2d 2d 2d 2d 2d 2d 2d 2d 2d 2d 2d 2d 0a 00  |--------------..|\n"
+                          "  expected @24: 2d 2d 2d 2d 2d 2d 2d 2d 2d 2d 2d 2d 2d 2d 2d 2d  |----------------|\n"
+                          "                                                          ^^\n"
+                          ") => true");
+    }
+#endif
+}
@@ -0,0 +1,212 @@
+//////
+/// \file     verify-content.test.cpp
+/// \brief    Test the verify_same_content() functionality.
+///
+/// \details  The hash must not depend on the instruction set, the digest must survive a round trip through a stream,
+///           and the reference must only be read for the chunk that differs.
+//////
+
+#include <verify-content.hpp> // DUT
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "pretty-file.h"
+
+#define DOCTEST_CONFIG_VOID_CAST_EXPRESSIONS
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+namespace {
+
+    using CppVerify::Kernels::Isa;
+
+    /// Run `check` once per instruction set, from the best supported one down to the scalar fallback.
+    template<typename F> void for_each_isa(F check)
+    {
+        const Isa selected = CppVerify::Kernels::isa();
+        for(int i = static_cast<int>(CppVerify::Kernels::detected_isa()); i >= 0; --i)
+        {
+            CppVerify::Kernels::isa() = static_cast<Isa>(i);
+            check();
+        }
+        CppVerify::Kernels::isa() = selected;
+    }
+
+    template<typename T> std::string to_string(const T & x)
+    {
+        std::stringstream os;
+        os << x;
+        return os.str();
+    }
+
+    std::vector<unsigned char> snapshot(const std::size_t n)
+    {
+        std::vector<unsigned char> bytes(n);
+        for(std::size_t i = 0; i < n; ++i)
+            bytes[i] = static_cast<unsigned char>('a' + (i * 7 + i / 26) % 26);
+        return bytes;
+    }
+
+    /// A reference in memory, that counts how often it is read.
+    struct Loader
+    {
+        const std::vector<unsigned char> & bytes;
+        int & reads;
+
+        bool operator()(const std::size_t offset, unsigned char * to, const std::size_t n) const
+        {
+            ++reads;
+            std::copy(bytes.begin() + static_cast<std::ptrdiff_t>(offset), bytes.begin() + static_cast<std::ptrdiff_t>(offset + n), to);
+            return true;
+        }
+    };
+
+}
+
+TEST_SUITE(__PRETTY_FILE__)
+{
+    TEST_CASE("hash() with every instruction set")
+    {
+        using CppVerify::Kernels::hash;
+
+        const std::vector<unsigned char> bytes = snapshot(20000);
+        for(std::size_t n : {0, 1, 127, 128, 129, 2047, 2048, 2049, 4096, 20000})
+        {
+            CppVerify::Kernels::isa() = Isa::scalar;
+            const auto expected = hash(bytes.data(), n);
+            CppVerify::Kernels::isa() = CppVerify::Kernels::detected_isa();
+            for_each_isa([&] {
+                CHECK(hash(bytes.data(), n) == expected);
+            });
+        }
+
+        // The length is part of the hash, even if the padding is the same.
+        const std::vector<unsigned char> zeros(256, 0);
+        CHECK(hash(zeros.data(), 100) != hash(zeros.data(), 101));
+        CHECK(hash(zeros.data(), 128) != hash(zeros.data(), 256));
+
+        // Any bit of any stripe changes the hash, and so does swapping stripes.
+        for_each_isa([&] {
+            std::vector<unsigned char> changed = bytes;
+            changed[3000] ^= 0x10;
+            CHECK(hash(changed.data(), changed.size()) != hash(bytes.data(), bytes.size()));
+            changed = bytes;
+            std::swap_ranges(changed.begin(), changed.begin() + 128, changed.begin() + 128);
+            CHECK(hash(changed.data(), 2048) != hash(bytes.data(), 2048));
+        });
+    }
+
+    TEST_CASE("Digest round trip")
+    {
+        const std::vector<unsigned char> bytes = snapshot(1000);
+        const CppVerify::Digest written = CppVerify::digest(bytes, 256);
+        CHECK(written.hashes().size() == 4u);
+
+        std::stringstream stream;
+        stream << written;
+        CppVerify::Digest read;
+        CHECK(stream >> read);
+        CHECK(read.size() == 1000u);
+        CHECK(read.chunk() == 256u);
+        CHECK(read.hashes() == written.hashes());
+
+        std::stringstream truncated(stream.str().substr(0, stream.str().size() - 40));
+        CHECK_FALSE(truncated >> read);
+        std::stringstream other("cpp-verify-digest 2 1000 256\n");
+        CHECK_FALSE(other >> read);
+
+        // A malformed header must not allocate (or throw) for the hashes it claims.
+        std::stringstream huge("cpp-verify-digest 1 18446744073709551615 1\n0123456789abcdef0123456789abcdef\n");
+        CHECK_FALSE(huge >> read);
+        std::stringstream negative("cpp-verify-digest 1 -1 0\n");
+        CHECK_FALSE(negative >> read);
+        std::stringstream long_word("cpp-verify-digest 1 1 1\n" + std::string(1000, '0') + "\n");
+        CHECK_FALSE(long_word >> read);
+        CHECK(read.hashes() == written.hashes());
+    }
+
+    TEST_CASE("verify_same_content()")
+    {
+        const std::vector<unsigned char> bytes = snapshot(1000);
+        const CppVerify::Digest expected = CppVerify::digest(bytes, 256);
+        std::vector<unsigned char> changed = bytes;
+        changed[600] = '!';
+
+        CHECK(verify_same_content(bytes, expected));
+        CHECK(verify_same_content(bytes.data(), bytes.size(), expected));
+        CHECK_FALSE(verify_same_content(changed, expected));
+        CHECK_FALSE(verify_same_content(bytes.data(), 999, expected));
+        CHECK_FALSE(verify_same_content(changed, CppVerify::Digest()));
+    }
+
+#if CPP_VERIFY_DECOMPOSE
+    TEST_CASE("verify_same_content() printing")
+    {
+        const std::vector<unsigned char> bytes = snapshot(1000);
+        const CppVerify::Digest expected = CppVerify::digest(bytes, 256);
+        std::vector<unsigned char> changed = bytes;
+        changed[600] = '!';
+        changed[900] = '!';
+
+        CHECK(to_string(verify_same_content(bytes, expected)) == "verify_same_content(bytes, expected) => verify_same_content(1000 bytes, 4 chunks as in the digest) => true");
+        CHECK(to_string(verify_same_content(changed, expected))
+              == "verify_same_content(changed, expected) => verify_same_content(1000 bytes, chunk 2 of 4 differs from the digest at bytes [512, 768)) => false");
+
+        const std::vector<unsigned char> longer = snapshot(1100);
+        CHECK(to_string(verify_same_content(longer.data(), 200, expected))
+              == "verify_same_content(longer.data(), 200, expected) => verify_same_content(200 bytes vs. 1000 bytes in the digest, chunk 0 of 4 differs from the digest at bytes [0, 200)) => false");
+        CHECK(to_string(verify_same_content(longer.data(), 512, expected))
+              == "verify_same_content(longer.data(), 512, expected) => verify_same_content(512 bytes vs. 1000 bytes in the digest, chunk 2 of 4 is missing) => false");
+        CHECK(to_string(verify_same_content(longer, expected))
+              == "verify_same_content(longer, expected) => verify_same_content(1100 bytes vs. 1000 bytes in the digest, chunk 3 of 5 differs from the digest at bytes [768, 1024)) => false");
+    }
+
+    TEST_CASE("verify_same_content() with a reference")
+    {
+        const std::vector<unsigned char> bytes = snapshot(1000);
+        const CppVerify::Digest expected = CppVerify::digest(bytes, 256);
+        std::vector<unsigned char> changed = bytes;
+        changed[600] = '!';
+        changed[900] = '!';
+
+        // Passing, the reference isn't read at all. Failing, just the chunk that differs is.
+        int reads = 0;
+        CHECK(verify_same_content(bytes, expected, Loader{bytes, reads}));
+        CHECK(reads == 0);
+        CHECK(to_string(verify_same_content(changed, expected, Loader{bytes, reads}))
+              == "verify_same_content(changed, expected, Loader{bytes, reads}) => verify_same_content(1000 bytes, chunk 2 of 4 differs from the digest, first difference at offset 600 of 1000 bytes\n"
+                 "  actual   @592: 67 6e 75 62 69 70 78 65 21 73 7a 67 6e 75 62 69  |gnubipxe!szgnubi|\n"
+                 "  expected @592: 67 6e 75 62 69 70 78 65 6c 73 7a 67 6e 75 62 69  |gnubipxelszgnubi|\n"
+                 "                                         ^^\n"
+                 ") => false");
+        CHECK(reads == 1);
+
+        // The reference differs from the digest, but not from the chunk.
+        CHECK(to_string(verify_same_content(bytes, CppVerify::digest(changed, 256), Loader{bytes, reads}))
+              == "verify_same_content(bytes, CppVerify::digest(changed, 256), Loader{bytes, reads}) => verify_same_content(1000 bytes, chunk 2 of 4 differs from the digest, but the reference agrees with its bytes [512, 768)) => false");
+    }
+
+    TEST_CASE("verify_same_content() with a reference file")
+    {
+        const std::vector<unsigned char> bytes = snapshot(1000);
+        const std::string path = (std::filesystem::temp_directory_path() / "verify-content.test.bin").string();
+        std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+
+        std::vector<unsigned char> changed = bytes;
+        changed[999] = '!';
+        const auto result = verify_same_content(changed, CppVerify::digest(bytes, 256), CppVerify::reference_file(path));
+        CHECK(to_string(result).find("first difference at offset 999 of 1000 bytes") != std::string::npos);
+        std::remove(path.c_str());
+
+        CHECK(to_string(verify_same_content(changed, CppVerify::digest(bytes, 256), CppVerify::reference_file(path)))
+              .find("differs from the digest (the reference is not available) at bytes [768, 1000)") != std::string::npos);
+    }
+#endif
+}
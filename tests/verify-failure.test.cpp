@@ -0,0 +1,150 @@
+//////
+/// \file     verify-failure.test.cpp
+/// \brief    Test CppVerify::Failure.
+///
+/// \details  A `Failure` must print just like the result it was made of, after its operands are gone,
+///           after being moved (between threads, too), and whether the result is kept inline or on the heap.
+//////
+
+#include <verify-failure.hpp> // DUT
+#include <verify-all.hpp> // DUT
+
+#include <array>
+#include <deque>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "pretty-file.h"
+
+#define DOCTEST_CONFIG_VOID_CAST_EXPRESSIONS
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+namespace {
+
+    template<typename T> std::string to_string(const T & x)
+    {
+        std::stringstream os;
+        os << x;
+        return os.str();
+    }
+
+#if CPP_VERIFY_DECOMPOSE
+    using Large = std::array<int, 32>;
+
+    std::string name() { return "a name, not short at all"; }
+#endif
+
+}
+
+TEST_SUITE(__PRETTY_FILE__)
+{
+    TEST_CASE("Failure of small operands")
+    {
+        using CppVerify::Failure;
+
+        static_assert(!std::is_copy_constructible_v<Failure>);
+        static_assert(std::is_nothrow_move_constructible_v<Failure>);
+
+        int price = -1;
+        const auto fail = !verify(price > 0);
+        const auto pass = verify(price < 0);
+        Failure failure(fail, "orders.cpp", 42);
+        const Failure anonymous(pass);
+        price = 1;
+
+        CHECK_FALSE(failure.on_heap());
+        CHECK(failure.line() == 42u);
+        CHECK(to_string(failure) == "orders.cpp:42: " + to_string(fail));
+        CHECK(to_string(anonymous) == to_string(pass));
+
+        // Moved from, a Failure prints its site only.
+        Failure moved(std::move(failure));
+        CHECK(to_string(moved) == "orders.cpp:42: " + to_string(fail));
+        CHECK(to_string(failure) == "orders.cpp:42: ");
+    }
+
+#if CPP_VERIFY_DECOMPOSE
+    TEST_CASE("Failure of referred operands")
+    {
+        using CppVerify::Failure;
+
+        std::vector<Failure> failures;
+        {
+            const std::string actual = name();
+            const std::string expected = "another name, not short";
+            const char * const pointer = actual.c_str();
+            const std::string_view view = actual;
+            const Large large{};
+
+            failures.emplace_back(verify(actual == expected));
+            failures.emplace_back(!verify(pointer != expected));
+            failures.emplace_back(verify(view == "another"));
+            failures.emplace_back(verify(large == Large{1}));
+            failures.emplace_back(verify(actual == "x") && verify_lazily(pointer == expected));
+            failures.emplace_back(verify_all(large, ==, 1));
+        }
+
+        // The operands are all gone, just their copies are left.
+        CHECK(failures[3].on_heap());
+        CHECK(to_string(failures[0]) == "verify(actual == expected) => verify(a name, not short at all == another name, not short) => false");
+        CHECK(to_string(failures[1]) == "!verify(pointer != expected) => !verify(a name, not short at all != another name, not short) => false");
+        CHECK(to_string(failures[2]) == "verify(view == \"another\") => verify(a name, not short at all == another) => false");
+        CHECK(to_string(failures[3]) == "verify(large == Large{1}) => verify(32 elements == 32 elements, 2 edits:\n"
+                                        "  - [0]: 0\n"
+                                        "  + [0]: 1\n"
+                                        ") => false");
+        CHECK(to_string(failures[4]) == "(verify(actual == \"x\") => verify(a name, not short at all == x) => false) && "
+                                        "(verify(pointer == expected) => not evaluated) => false");
+        CHECK(to_string(failures[5]).find("=> false") != std::string::npos);
+    }
+
+    TEST_CASE("Failure of owned operands")
+    {
+        using CppVerify::Failure;
+
+        // Handed over as rvalue, the owned operand is moved instead of copied.
+        auto owned = verify_owned(name() == std::string("other"));
+        const std::string before = to_string(owned);
+        const Failure failure(std::move(owned));
+        CHECK(to_string(failure) == before);
+        CHECK(owned.expression.operand1.empty());
+
+        // So are the owned operands of both sides of an aggregation.
+        auto aggregated = verify_owned(name() != std::string("other")) && verify_lazily(name() == std::string("other"));
+        const std::string printed = to_string(aggregated);
+        const Failure junction(std::move(aggregated));
+        CHECK(to_string(junction) == printed);
+        CHECK(aggregated.lhs.expression.operand1.empty());
+        CHECK(aggregated.rhs->expression.operand1.empty());
+    }
+
+    TEST_CASE("Failure across threads")
+    {
+        using CppVerify::Failure;
+
+        // Producers only copy, the consumer renders.
+        std::deque<Failure> queue;
+        std::thread producer([&queue] {
+            for(int i = 0; i < 100; ++i)
+            {
+                const std::string item = "item " + std::to_string(i);
+                if(auto fail = !verify(i % 10 != 0))
+                    queue.emplace_back(fail, "producer.cpp", 7);
+                if(auto fail = !verify(item.size() < 6u))
+                    queue.emplace_back(fail);
+            }
+        });
+        producer.join();
+
+        REQUIRE(queue.size() == 110u);
+        CHECK(to_string(queue.front()) == "producer.cpp:7: !verify(i % 10 != 0) => !verify(0 != 0) => true");
+        CHECK(to_string(queue.back()) == "!verify(item.size() < 6u) => !verify(7 < 6) => true");
+    }
+#endif
+}
@@ -0,0 +1,176 @@
+//////
+/// \file     verify-golden.test.cpp
+/// \brief    Test the verify_matches_golden() functionality.
+///
+/// \details  The golden file must be compared in place, without any allocation on the passing path,
+///           and the new output must only be written on request, and only if it differs.
+//////
+
+#include <verify-golden.hpp> // DUT
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <sys/stat.h>
+#endif
+
+#include "pretty-file.h"
+
+#define DOCTEST_CONFIG_VOID_CAST_EXPRESSIONS
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+namespace {
+
+    template<typename T> std::string to_string(const T & x)
+    {
+        std::stringstream os;
+        os << x;
+        return os.str();
+    }
+
+    /// A golden file in the temporary directory, removed (with its ".new" file) at the end of the test.
+    struct Golden
+    {
+        std::string path;
+
+        Golden(const char * name, const std::string & content)
+            : path((std::filesystem::temp_directory_path() / name).string())
+        {
+            std::ofstream(path, std::ios::binary) << content;
+        }
+
+        ~Golden()
+        {
+            std::remove(path.c_str());
+            std::remove((path + ".new").c_str());
+        }
+
+        std::string fresh() const
+        {
+            std::ifstream file(path + ".new", std::ios::binary);
+            return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+    };
+
+}
+
+TEST_SUITE(__PRETTY_FILE__)
+{
+    TEST_CASE("verify_matches_golden()")
+    {
+        const Golden golden("verify-golden.test.txt", "Hello world!");
+        const std::string same = "Hello world!";
+        const std::string other = "Hello World!";
+        const std::string longer = "Hello world!!";
+
+        CHECK(verify_matches_golden(same, golden.path));
+        CHECK(verify_matches_golden(same.data(), same.size(), golden.path.c_str()));
+        CHECK_FALSE(verify_matches_golden(other, golden.path));
+        CHECK_FALSE(verify_matches_golden(longer, golden.path));
+        CHECK_FALSE(verify_matches_golden(same.data(), 11, golden.path));
+        CHECK_FALSE(verify_matches_golden(same, golden.path + ".missing"));
+
+        const Golden empty("verify-golden.test.empty", "");
+        CHECK(verify_matches_golden(std::string(), empty.path));
+        CHECK_FALSE(verify_matches_golden(same, empty.path));
+    }
+
+    TEST_CASE("verify_matches_golden() against a directory")
+    {
+        // Neither mapped nor read (with CPP_VERIFY_MMAP=0), but not readable either way.
+        const std::string directory = std::filesystem::temp_directory_path().string();
+        const CppVerify::MappedFile mapped(directory.c_str());
+        CHECK_FALSE(mapped);
+        CHECK(mapped.error() == EISDIR);
+        CHECK(mapped.size() == 0u);
+
+        const std::string same = "Hello world!";
+        CHECK_FALSE(verify_matches_golden(same, directory));
+#if CPP_VERIFY_DECOMPOSE
+        CHECK(to_string(verify_matches_golden(same, directory)).find("=> verify_matches_golden(golden file " + directory + " not readable (") != std::string::npos);
+#endif
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    TEST_CASE("verify_matches_golden() against other special files")
+    {
+        // Devices and FIFOs have no size (and reading a FIFO would wait for a writer), so they aren't regular golden files.
+        const CppVerify::MappedFile device("/dev/null");
+        CHECK_FALSE(device);
+        CHECK(device.error() == EINVAL);
+
+        const std::string fifo = (std::filesystem::temp_directory_path() / "verify-golden.test.fifo").string();
+        std::remove(fifo.c_str());
+        REQUIRE(::mkfifo(fifo.c_str(), 0600) == 0);
+        const CppVerify::MappedFile pipe(fifo.c_str());
+        CHECK_FALSE(pipe);
+        CHECK(pipe.error() == EINVAL);
+        CHECK_FALSE(verify_matches_golden(std::string(), fifo));
+        std::remove(fifo.c_str());
+    }
+#endif
+
+#if CPP_VERIFY_DECOMPOSE
+    TEST_CASE("verify_matches_golden() without allocation")
+    {
+        const Golden golden("verify-golden.test.bin", std::string(1 << 20, 'x'));
+        std::vector<char> output(1 << 20, 'x');
+        const char * const path = golden.path.c_str();
+
+        // Passing, the path is the only thing that could have been allocated, and it isn't kept.
+        const auto pass = verify_matches_golden(output, path);
+        CHECK(pass);
+        CHECK(pass.expression.path.empty());
+
+        output.back() = 'y';
+        const auto fail = verify_matches_golden(output, path);
+        CHECK_FALSE(fail);
+        CHECK(fail.expression.path == golden.path);
+    }
+#endif
+
+    TEST_CASE("verify_matches_golden() writing the new output")
+    {
+        const Golden golden("verify-golden.test.new", "Hello world!");
+
+        CHECK(verify_matches_golden(std::string("Hello world!"), golden.path, CppVerify::write_new));
+        CHECK(golden.fresh().empty());
+        CHECK_FALSE(verify_matches_golden(std::string("Hello World!"), golden.path, CppVerify::write_new));
+        CHECK(golden.fresh() == "Hello World!");
+
+        // A missing golden file is written as well, so that it can be created from the output.
+        const Golden missing("verify-golden.test.missing", "");
+        std::remove(missing.path.c_str());
+        CHECK_FALSE(verify_matches_golden(std::string("first"), missing.path, CppVerify::write_new));
+        CHECK(missing.fresh() == "first");
+    }
+
+#if CPP_VERIFY_DECOMPOSE
+    TEST_CASE("verify_matches_golden() printing")
+    {
+        const Golden golden("verify-golden.test.print", "Hello world!");
+        const std::string & path = golden.path;
+        const std::string other = "Hello World!";
+        const std::string longer = "Hello world!!";
+
+        CHECK(to_string(verify_matches_golden(std::string("Hello world!"), path)).find("=> verify_matches_golden(12 bytes as in the golden file) => true") != std::string::npos);
+        CHECK(to_string(verify_matches_golden(other, path)) == "verify_matches_golden(other, path) => verify_matches_golden(differs from " + path + ", first difference at offset 6 of 12 bytes\n"
+                                                               "  actual   @0: 48 65 6c 6c 6f 20 57 6f 72 6c 64 21  |Hello World!|\n"
+                                                               "  expected @0: 48 65 6c 6c 6f 20 77 6f 72 6c 64 21  |Hello world!|\n"
+                                                               "                                 ^^\n"
+                                                               ") => false");
+        CHECK(to_string(verify_matches_golden(longer, path)) == "verify_matches_golden(longer, path) => verify_matches_golden(13 bytes vs. 12 bytes in " + path + ", equal up to offset 12) => false");
+        CHECK(to_string(verify_matches_golden(other, path, CppVerify::write_new)).find("differs from " + path + " (new output in " + path + ".new), first difference at offset 6") != std::string::npos);
+        CHECK(to_string(verify_matches_golden(other, path + ".missing")) == "verify_matches_golden(other, path + \".missing\") => verify_matches_golden(golden file " + path + ".missing not readable (No such file or directory)) => false");
+    }
+#endif
+}
@@ -0,0 +1,161 @@
+//////
+/// \file     verify-invariants.test.cpp
+/// \brief    Test verify_sorted(), verify_unique(), verify_partitioned() and verify_heap().
+///
+/// \details  The results must agree with the standard algorithms, for every available instruction set.
+//////
+
+#include <verify-invariants.hpp> // DUT
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "pretty-file.h"
+
+#define DOCTEST_CONFIG_VOID_CAST_EXPRESSIONS
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+namespace {
+
+    using CppVerify::Kernels::Isa;
+
+    /// Run `check` once per instruction set, from the best supported one down to the scalar fallback.
+    template<typename F> void for_each_isa(F check)
+    {
+        const Isa selected = CppVerify::Kernels::isa();
+        for(int i = static_cast<int>(CppVerify::Kernels::detected_isa()); i >= 0; --i)
+        {
+            CppVerify::Kernels::isa() = static_cast<Isa>(i);
+            check();
+        }
+        CppVerify::Kernels::isa() = selected;
+    }
+
+    /// Each position of a single inversion, in arrays around the sizes of the vector blocks.
+    template<typename T> void check_single_inversions()
+    {
+        for(std::size_t n : {0, 1, 2, 17, 64, 65, 127, 257, 1000})
+        {
+            if(n > static_cast<std::size_t>(std::numeric_limits<T>::max()))
+                continue;
+
+            std::vector<T> x(n);
+            std::iota(x.begin(), x.end(), T(0));
+            CHECK(verify_sorted(x));
+            CHECK(verify_unique(x));
+            CHECK(static_cast<bool>(verify_sorted(x, std::greater<>())) == (n < 2));
+
+            for(std::size_t i = 1; i < n; i += 1 + (i / 4))
+            {
+                std::swap(x[i - 1], x[i]);
+                const auto sorted = verify_sorted(x);
+                CHECK_FALSE(sorted);
+#if CPP_VERIFY_DECOMPOSE
+                CHECK(sorted.expression.violation.first == i - 1);
+                CHECK(sorted.expression.violation.second == i);
+#endif
+                std::swap(x[i - 1], x[i]);
+
+                const T kept = x[i];
+                x[i] = x[i - 1];
+                const auto unique = verify_unique(x);
+                CHECK_FALSE(unique);
+#if CPP_VERIFY_DECOMPOSE
+                CHECK(unique.expression.violation.first == i - 1);
+#endif
+                x[i] = kept;
+            }
+        }
+    }
+
+}
+
+TEST_SUITE(__PRETTY_FILE__)
+{
+    TEST_CASE("verify_sorted()")
+    {
+        const std::vector<int> ascending = {1, 2, 2, 3, 5, 8};
+        const std::vector<int> descending = {8, 5, 3, 2, 2, 1};
+        const std::vector<std::string> names = {"ada", "bob", "cyd"};
+
+        CHECK(verify_sorted(ascending));
+        CHECK(verify_sorted(ascending, std::less<int>()));
+        CHECK_FALSE(verify_sorted(descending));
+        CHECK(verify_sorted(descending, std::greater<>()));
+        CHECK(verify_sorted(descending, [](int a, int b) { return a > b; }));
+        CHECK(verify_sorted(names));
+        CHECK(!verify_sorted(names, std::greater<>()));
+    }
+
+    TEST_CASE("verify_sorted() and verify_unique() with every instruction set")
+    {
+        for_each_isa([] {
+            check_single_inversions<std::int8_t>();
+            check_single_inversions<std::uint16_t>();
+            check_single_inversions<int>();
+            check_single_inversions<std::int64_t>();
+            check_single_inversions<float>();
+            check_single_inversions<double>();
+        });
+    }
+
+    TEST_CASE("verify_sorted() with NaN, just like std::is_sorted()")
+    {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        for_each_isa([nan] {
+            std::vector<double> x(100);
+            std::iota(x.begin(), x.end(), 0.0);
+            x[50] = nan;
+            CHECK(static_cast<bool>(verify_sorted(x)) == std::is_sorted(x.begin(), x.end()));
+            x[70] = 0.0;
+            CHECK(static_cast<bool>(verify_sorted(x)) == std::is_sorted(x.begin(), x.end()));
+            CHECK(verify_unique(x));
+        });
+    }
+
+    TEST_CASE("verify_partitioned()")
+    {
+        const auto even = [](int x) { return x % 2 == 0; };
+        CHECK(verify_partitioned(std::vector<int>{2, 4, 6, 1, 3}, even));
+        CHECK(verify_partitioned(std::vector<int>{1, 3}, even));
+        CHECK(verify_partitioned(std::vector<int>{}, even));
+        CHECK_FALSE(verify_partitioned(std::vector<int>{2, 1, 4}, even));
+    }
+
+    TEST_CASE("verify_heap()")
+    {
+        std::vector<int> x = {3, 1, 4, 1, 5, 9, 2, 6};
+        CHECK_FALSE(verify_heap(x));
+        std::make_heap(x.begin(), x.end());
+        CHECK(verify_heap(x));
+        CHECK_FALSE(verify_heap(x, std::greater<>()));
+        std::make_heap(x.begin(), x.end(), std::greater<>());
+        CHECK(verify_heap(x, std::greater<>()));
+    }
+
+#if CPP_VERIFY_DECOMPOSE
+    TEST_CASE("verify_sorted() and friends printing")
+    {
+        const std::vector<int> keys = {1, 2, 5, 3};
+        const std::vector<int> twice = {1, 2, 2};
+        const std::vector<int> heap = {1, 5};
+
+        std::stringstream os;
+        os << verify_sorted(keys) << '\n' << verify_sorted(twice) << '\n' << verify_unique(twice) << '\n'
+           << !verify_partitioned(keys, [](int x) { return x % 2 == 1; }) << '\n' << verify_heap(heap);
+        CHECK(os.str() == "verify_sorted(keys) => verify_sorted([2]: 5, [3]: 3 out of order) => false\n"
+                          "verify_sorted(twice) => verify_sorted(3 elements in order) => true\n"
+                          "verify_unique(twice) => verify_unique([1]: 2, [2]: 2 are adjacent duplicates) => false\n"
+                          "!verify_partitioned(keys, [](int x) { return x % 2 == 1; }) => !verify_partitioned([1]: 2, [2]: 5 violate the partition) => true\n"
+                          "verify_heap(heap) => verify_heap([0]: 1, [1]: 5 violate the heap order) => false");
+    }
+#endif
+}
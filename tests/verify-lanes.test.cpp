@@ -0,0 +1,139 @@
+//////
+/// \file     verify-lanes.test.cpp
+/// \brief    Test the verify_lanes() functionality.
+///
+/// \details  Every lane of every vector width must be checked, and only the failing lanes reported.
+//////
+
+#include <verify-lanes.hpp> // DUT
+
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+
+#include "pretty-file.h"
+
+#define DOCTEST_CONFIG_VOID_CAST_EXPRESSIONS
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+namespace {
+
+    template<typename T, std::size_t Bytes> using Vector = typename CppVerify::LaneVector<T, Bytes>::type;
+
+    /// A single failing lane at each position, for each comparison.
+    template<typename T, std::size_t Bytes> void check_single_failures()
+    {
+        constexpr std::size_t lanes = Bytes / sizeof(T);
+        Vector<T, Bytes> x{};
+        for(std::size_t i = 0; i < lanes; ++i)
+            x[i] = static_cast<T>(i % 100);
+        const Vector<T, Bytes> y = x;
+
+        CHECK(verify_lanes(x, ==, y));
+        CHECK(verify_lanes(x, <=, y));
+        CHECK(verify_lanes(x, >=, y));
+        CHECK(verify_lanes(x, <, 100));
+        CHECK_FALSE(verify_lanes(x, !=, y));
+
+        for(std::size_t i = 0; i < lanes; ++i)
+        {
+            Vector<T, Bytes> z = y;
+            z[i] = static_cast<T>(z[i] + 1);
+            const auto equal = verify_lanes(x, ==, z);
+            const auto less = verify_lanes(x, <, z);
+            CHECK_FALSE(equal);
+            CHECK_FALSE(less);
+            CHECK(verify_lanes(x, <=, z));
+            CHECK(verify_lanes(z, >=, x));
+#if CPP_VERIFY_DECOMPOSE
+            const std::uint64_t all = (lanes == 64) ? ~std::uint64_t(0) : ((std::uint64_t(1) << lanes) - 1);
+            CHECK((~CppVerify::passing_lanes<CppVerify::EQ>(equal.expression.op1, equal.expression.op2) & all) == (std::uint64_t(1) << i));
+            CHECK(CppVerify::passing_lanes<CppVerify::LT>(less.expression.op1, less.expression.op2) == (std::uint64_t(1) << i));
+#endif
+        }
+    }
+
+}
+
+TEST_SUITE(__PRETTY_FILE__)
+{
+    TEST_CASE("verify_lanes() on every lane")
+    {
+        check_single_failures<std::int8_t, 16>();
+        check_single_failures<std::uint8_t, 64>();
+        check_single_failures<std::int16_t, 32>();
+        check_single_failures<std::int32_t, 16>();
+        check_single_failures<std::uint32_t, 32>();
+        check_single_failures<std::int64_t, 16>();
+        check_single_failures<float, 8>();
+        check_single_failures<float, 32>();
+        check_single_failures<double, 64>();
+    }
+
+    TEST_CASE("verify_lanes() of intrinsics")
+    {
+#if defined(__SSE2__)
+        const __m128i counts = _mm_setr_epi32(1, 2, 3, 4);
+        const __m128i expected = _mm_setr_epi32(1, 2, 3, 5);
+        const __m128 sums = _mm_setr_ps(1.0f, -2.0f, 3.0f, 0.0f);
+
+        CHECK(verify_lanes(counts, ==, counts));
+        CHECK_FALSE(verify_lanes(counts, ==, expected));
+        CHECK(verify_lanes(CppVerify::lanes<std::int32_t>(counts), <=, expected));
+        CHECK(verify_lanes(CppVerify::lanes<std::int32_t>(counts), >, 0));
+        CHECK_FALSE(verify_lanes(CppVerify::lanes<std::int8_t>(counts), >, 0));
+        CHECK(verify_lanes(CppVerify::lanes<std::uint8_t>(counts), <, 6));
+        CHECK(verify_lanes(sums, >=, -2.0f));
+        CHECK_FALSE(verify_lanes(sums, >=, 0.0f));
+#endif
+    }
+
+    TEST_CASE("verify_lanes() with NaN")
+    {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        const Vector<double, 32> x = {1.0, nan, 3.0, 4.0};
+
+        CHECK_FALSE(verify_lanes(x, ==, x));
+        CHECK_FALSE(verify_lanes(x, !=, x));
+        CHECK_FALSE(verify_lanes(x, >, 0.0));
+        CHECK_FALSE(verify_lanes(x, <=, 4.0));
+    }
+
+#if defined(__cpp_lib_experimental_parallel_simd)
+    TEST_CASE("verify_lanes() of std::experimental::simd")
+    {
+        namespace stdx = std::experimental;
+        const stdx::fixed_size_simd<float, 4> x([](int i) { return static_cast<float>(i); });
+        const Vector<float, 16> y = {0.0f, 1.0f, 2.0f, 3.0f};
+
+        CHECK(verify_lanes(x, ==, x));
+        CHECK(verify_lanes(x, ==, y));
+        CHECK(verify_lanes(y, ==, x));
+        CHECK(verify_lanes(x, <, 4.0f));
+        CHECK_FALSE(verify_lanes(x, >, 0.0f));
+    }
+#endif
+
+#if CPP_VERIFY_DECOMPOSE
+    TEST_CASE("verify_lanes() printing")
+    {
+        const Vector<float, 32> sums = {1, 2, -1, 4, 5, -3, 7, 8};
+        const Vector<std::int8_t, 16> bytes = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -1};
+        Vector<std::uint8_t, 64> wide{};
+        for(std::size_t i = 0; i < 64; i += 2)
+            wide[i] = 1;
+
+        std::stringstream os;
+        os << verify_lanes(sums, >=, 0.0f) << '\n' << verify_lanes(sums, <, 9) << '\n' << !verify_lanes(bytes, ==, 0) << '\n'
+           << verify_lanes(wide, ==, 1);
+        CHECK(os.str() == "verify_lanes(sums >= 0.0f) => verify_lanes([2]: -1 >= 0, [5]: -3 >= 0; 2 of 8 lanes fail (mask 0x24)) => false\n"
+                          "verify_lanes(sums < 9) => verify_lanes(8 of 8 lanes pass) => true\n"
+                          "!verify_lanes(bytes == 0) => !verify_lanes([15]: -1 == 0; 1 of 16 lanes fail (mask 0x8000)) => true\n"
+                          "verify_lanes(wide == 1) => verify_lanes([1]: 0 == 1, [3]: 0 == 1, [5]: 0 == 1, [7]: 0 == 1, [9]: 0 == 1, [11]: 0 == 1, "
+                          "[13]: 0 == 1, [15]: 0 == 1, [17]: 0 == 1, [19]: 0 == 1, [21]: 0 == 1, [23]: 0 == 1, [25]: 0 == 1, [27]: 0 == 1, "
+                          "[29]: 0 == 1, [31]: 0 == 1, ...; 32 of 64 lanes fail (mask 0xaaaaaaaaaaaaaaaa)) => false");
+    }
+#endif
+}
@@ -0,0 +1,174 @@
+//////
+/// \file     verify-recorded.test.cpp
+/// \brief    Test the recorded() functionality.
+///
+/// \details  An input range must be read exactly once, by the comparison, and still be printed from what was recorded.
+//////
+
+#include <verify-recorded.hpp> // DUT
+
+#include <cstddef>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+#if defined(__cpp_lib_ranges)
+    #include <ranges>
+#endif
+
+#include "pretty-file.h"
+
+#define DOCTEST_CONFIG_VOID_CAST_EXPRESSIONS
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+namespace {
+
+    template<typename T> std::string to_string(const T & x)
+    {
+        std::stringstream os;
+        os << x;
+        return os.str();
+    }
+
+    /// A single-pass generator of `0, 1, 2, ...` (up to `end`), counting the elements it is read by.
+    struct Counter
+    {
+        using iterator_category = std::input_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int *;
+        using reference = const int &;
+
+        int * reads;
+        int value;
+
+        const int & operator*() const { ++*reads; return value; }
+        Counter & operator++() { ++value; return *this; }
+        bool operator==(const Counter & other) const { return value == other.value; }
+        bool operator!=(const Counter & other) const { return value != other.value; }
+    };
+
+    std::vector<int> iota(const int n)
+    {
+        std::vector<int> numbers;
+        for(int i = 0; i < n; ++i)
+            numbers.push_back(i);
+        return numbers;
+    }
+
+}
+
+TEST_SUITE(__PRETTY_FILE__)
+{
+    TEST_CASE("recorded() input ranges")
+    {
+        using CppVerify::recorded;
+
+        std::istringstream equal("1 2 3");
+        std::istringstream longer("1 2 3 4");
+        std::istringstream shorter("1 2");
+        const std::vector<int> expected{1, 2, 3};
+
+        CHECK(recorded(std::istream_iterator<int>(equal), std::istream_iterator<int>()) == expected);
+        CHECK(recorded(std::istream_iterator<int>(longer), std::istream_iterator<int>()) != expected);
+        CHECK_FALSE(recorded(std::istream_iterator<int>(shorter), std::istream_iterator<int>()) == expected);
+
+        // Compared once, the result is kept, instead of reading on.
+        std::istringstream once("4");
+        const auto numbers = recorded(std::istream_iterator<int>(once), std::istream_iterator<int>());
+        CHECK(numbers == std::vector<int>{4});
+        CHECK(numbers == std::vector<int>{4});
+        CHECK(numbers.at_end());
+    }
+
+    TEST_CASE("recorded() reads once")
+    {
+        using CppVerify::recorded;
+
+        int reads = 0;
+        const auto numbers = recorded(Counter{&reads, 0}, Counter{&reads, 100});
+        CHECK_FALSE(numbers == iota(50));
+        CHECK(reads == 51);
+        CHECK(numbers.size() == 51u);
+        CHECK(numbers.start() == 51u - CPP_VERIFY_RANGE_ELEMENTS);
+        CHECK(numbers[50] == 50);
+
+        // Printing is done from the recording.
+        const std::string printed = to_string(numbers);
+        CHECK(reads == 51);
+        CHECK(printed == "{..., 43, 44, 45, 46, 47, 48, 49, 50}");
+    }
+
+#if CPP_VERIFY_DECOMPOSE
+    TEST_CASE("recorded() printing, short")
+    {
+        using CppVerify::recorded;
+
+        std::istringstream in("1 2");
+        const auto numbers = recorded(std::istream_iterator<int>(in), std::istream_iterator<int>());
+        const std::vector<int> expected{1, 2, 3};
+        CHECK(to_string(verify(numbers == expected)) == "verify(numbers == expected) => verify({1, 2} == {1, 2, 3}) => false");
+    }
+
+    TEST_CASE("recorded() printing, stopped early")
+    {
+        using CppVerify::recorded;
+
+        std::istringstream in("0 1 9 3");
+        const auto numbers = recorded(std::istream_iterator<int>(in), std::istream_iterator<int>());
+        const std::vector<int> expected{0, 1, 2, 3};
+        CHECK(to_string(verify(numbers == expected)) == "verify(numbers == expected) => verify(3 elements read == 4 elements, first difference at [2]: 9 vs. 2\n"
+                                                        "  read [0..2]: {0, 1, 9}\n"
+                                                        ") => false");
+    }
+
+    TEST_CASE("recorded() printing, long")
+    {
+        using CppVerify::recorded;
+
+        std::istringstream in("0 1 2 3 4 5 6 7 8 9 99 11");
+        const auto numbers = recorded(std::istream_iterator<int>(in), std::istream_iterator<int>());
+        CHECK(to_string(verify(numbers == iota(12))) == "verify(numbers == iota(12)) => verify(11 elements read == 12 elements, first difference at [10]: 99 vs. 10\n"
+                                                        "  read [3..10]: {..., 3, 4, 5, 6, 7, 8, 9, 99}\n"
+                                                        ") => false");
+    }
+
+    TEST_CASE("recorded() printing, long and short")
+    {
+        using CppVerify::recorded;
+
+        int reads = 0;
+        const auto numbers = recorded(Counter{&reads, 0}, Counter{&reads, 10});
+        CHECK(to_string(verify(numbers != iota(12))) == "verify(numbers != iota(12)) => verify(10 elements read != 12 elements, first difference at [10]: (end) vs. 10\n"
+                                                        "  read [2..9]: {..., 2, 3, 4, 5, 6, 7, 8, 9}\n"
+                                                        ") => true");
+        CHECK(reads == 10);
+    }
+
+    TEST_CASE("recorded() printing, owned")
+    {
+        using CppVerify::recorded;
+
+        std::istringstream in("0 2");
+        CHECK(to_string(verify_owned(recorded(std::istream_iterator<int>(in), std::istream_iterator<int>()) == iota(2)))
+              == "verify(recorded(std::istream_iterator<int>(in), std::istream_iterator<int>()) == iota(2)) => verify(2 elements read == 2 elements, first difference at [1]: 2 vs. 1\n"
+                 "  read [0..1]: {0, 2}\n"
+                 ") => false");
+    }
+#endif
+
+#if defined(__cpp_lib_ranges)
+    TEST_CASE("recorded() views")
+    {
+        using CppVerify::recorded;
+
+        std::istringstream in("1 2 3");
+        auto view = std::views::istream<int>(in);
+        const auto numbers = recorded(view);
+        const std::vector<int> expected{1, 2, 3};
+        CHECK(verify(numbers == expected));
+        CHECK(numbers.at_end());
+    }
+#endif
+}
@@ -0,0 +1,214 @@
+//////
+/// \file     verify-records.test.cpp
+/// \brief    Test the verify_records() functionality.
+///
+/// \details  All records must be checked, by any amount of threads, but just the first failures kept, in the order of the file.
+///           The chunks are small, so that even the few records of the tests are spread over threads.
+//////
+
+#define CPP_VERIFY_RECORD_CHUNK 16
+#define CPP_VERIFY_RECORD_FAILURES 3
+
+#include <verify-records.hpp> // DUT
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "pretty-file.h"
+
+#define DOCTEST_CONFIG_VOID_CAST_EXPRESSIONS
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+namespace {
+
+    template<typename T> std::string to_string(const T & x)
+    {
+        std::stringstream os;
+        os << x;
+        return os.str();
+    }
+
+    struct Order
+    {
+        std::int64_t id;
+        double price;
+        std::int32_t qty;
+        std::int32_t limit;
+    };
+
+    std::vector<Order> orders(const std::size_t n)
+    {
+        std::vector<Order> all(n);
+        for(std::size_t i = 0; i < n; ++i)
+            all[i] = Order{static_cast<std::int64_t>(i), 1.5 + static_cast<double>(i % 10), static_cast<std::int32_t>(i % 100), 1000};
+        return all;
+    }
+
+    /// Run `check` with one thread, and with more threads than chunks.
+    template<typename F> void for_each_threads(F check)
+    {
+        const unsigned threads = CppVerify::record_threads();
+        for(unsigned n : {1u, 4u, 64u})
+        {
+            CppVerify::record_threads() = n;
+            check();
+        }
+        CppVerify::record_threads() = threads;
+    }
+
+    /// A level that can't be compared, if it's negative.
+    struct Level
+    {
+        std::int32_t value;
+
+        bool operator>(const int x) const
+        {
+            if(value < 0)
+                throw std::domain_error("negative level");
+            return value > x;
+        }
+    };
+
+    /// A record that isn't default-constructible.
+    struct Sample
+    {
+        explicit Sample(std::int32_t v) : level{v} { }
+
+        Level level;
+    };
+
+    using CppVerify::field;
+
+    const auto price = field(&Order::price, "price");
+    const auto qty = field(&Order::qty, "qty");
+    const auto limit = field(&Order::limit, "limit");
+
+}
+
+TEST_SUITE(__PRETTY_FILE__)
+{
+    TEST_CASE("verify_records()")
+    {
+        for_each_threads([] {
+            std::vector<Order> all = orders(1000);
+            const std::size_t bytes = all.size() * sizeof(Order);
+
+            CHECK(verify_records(all.data(), bytes, price > 0.0, qty <= 1000));
+            CHECK(verify_records(all.data(), 0, price > 0.0));
+            CHECK_FALSE(verify_records(all.data(), bytes - 1, price > 0.0));
+
+            all[999].price = -1.0;
+            CHECK_FALSE(verify_records(all.data(), bytes, price > 0.0, qty <= 1000));
+            CHECK(verify_records(all.data(), bytes - sizeof(Order), price > 0.0, qty <= 1000));
+        });
+    }
+
+    TEST_CASE("verify_records() comparing fields")
+    {
+        for_each_threads([] {
+            std::vector<Order> all = orders(1000);
+            const std::size_t bytes = all.size() * sizeof(Order);
+
+            CHECK(verify_records(all.data(), bytes, qty <= limit, limit == 1000, qty < limit));
+            CHECK_FALSE(verify_records(all.data(), bytes, qty > limit));
+
+            all[555].limit = 10;
+            CHECK(verify_records(all.data(), bytes, limit > 0));
+            CHECK_FALSE(verify_records(all.data(), bytes, qty <= limit));
+        });
+    }
+
+    TEST_CASE("verify_records() with throwing checks")
+    {
+        for_each_threads([] {
+            std::vector<Sample> all(1000, Sample(1));
+            const std::size_t bytes = all.size() * sizeof(Sample);
+            const auto level = field(&Sample::level, "level");
+            CHECK(verify_records(all.data(), bytes, level > 0));
+
+            // Rethrown by the calling thread, once all threads are joined.
+            all[555].level.value = -1;
+            CHECK_THROWS_AS(verify_records(all.data(), bytes, level > 0), std::domain_error);
+        });
+    }
+
+    TEST_CASE("verify_records() on a file")
+    {
+        const std::vector<Order> all = orders(100);
+        const std::string path = (std::filesystem::temp_directory_path() / "verify-records.test.bin").string();
+        std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char *>(all.data()), static_cast<std::streamsize>(all.size() * sizeof(Order)));
+
+        CHECK(verify_records(path, price > 0.0, qty < 100));
+        CHECK(verify_records(path.c_str(), price > 0.0, qty < 100));
+        CHECK_FALSE(verify_records(path, qty < 99));
+        std::remove(path.c_str());
+
+        CHECK_FALSE(verify_records(path, price > 0.0));
+    }
+
+#if CPP_VERIFY_DECOMPOSE
+    TEST_CASE("verify_records() keeps the first failures")
+    {
+        for_each_threads([] {
+            std::vector<Order> all = orders(1000);
+            for(std::size_t i : {999, 17, 500, 18, 33})
+                all[i].qty = 2000;
+            all[17].price = -1.5;
+
+            const auto result = verify_records(all.data(), all.size() * sizeof(Order), price > 0.0, qty <= 1000);
+            CHECK_FALSE(result);
+            CHECK(result.expression.scan.failures == 5u);
+            REQUIRE(result.expression.scan.first.size() == 3u);
+            CHECK(result.expression.scan.first[0].index == 17u);
+            CHECK(result.expression.scan.first[1].index == 18u);
+            CHECK(result.expression.scan.first[2].index == 33u);
+        });
+    }
+
+    TEST_CASE("verify_records() printing")
+    {
+        std::vector<Order> all = orders(100);
+        const std::size_t bytes = all.size() * sizeof(Order);
+
+        CHECK(to_string(verify_records(all.data(), bytes, price > 0.0)) == "verify_records(all.data(), bytes, price > 0.0) => verify_records(100 records of 24 bytes passed) => true");
+        CHECK(to_string(verify_records(all.data(), bytes - 4, price > 0.0))
+              == "verify_records(all.data(), bytes - 4, price > 0.0) => verify_records(99 records of 24 bytes passed, 20 bytes left over) => false");
+
+        all[17].price = -1.5;
+        all[17].qty = 1200;
+        all[42].qty = 1001;
+        CHECK(to_string(verify_records(all.data(), bytes, price > 0.0, qty <= 1000))
+              == "verify_records(all.data(), bytes, price > 0.0, qty <= 1000) => verify_records(2 of 100 records failed:\n"
+                 "  [17] verify(price > 0) => verify(-1.5 > 0) => false; verify(qty <= 1000) => verify(1200 <= 1000) => false\n"
+                 "  [42] verify(qty <= 1000) => verify(1001 <= 1000) => false\n"
+                 ") => false");
+
+        for(std::size_t i : {50, 60, 70})
+            all[i].qty = 1001;
+        CHECK(to_string(verify_records(all.data(), bytes, qty <= 1000)).find("5 of 100 records failed:\n"
+                                                                              "  [17] verify(qty <= 1000) => verify(1200 <= 1000) => false\n"
+                                                                              "  [42] verify(qty <= 1000) => verify(1001 <= 1000) => false\n"
+                                                                              "  [50] verify(qty <= 1000) => verify(1001 <= 1000) => false\n"
+                                                                              "  ...\n") != std::string::npos);
+
+        all[17].limit = 100;
+        CHECK(to_string(verify_records(all.data(), bytes, qty <= limit)) == "verify_records(all.data(), bytes, qty <= limit) => verify_records(5 of 100 records failed:\n"
+                                                                            "  [17] verify(qty <= limit) => verify(1200 <= 100) => false\n"
+                                                                            "  [42] verify(qty <= limit) => verify(1001 <= 1000) => false\n"
+                                                                            "  [50] verify(qty <= limit) => verify(1001 <= 1000) => false\n"
+                                                                            "  ...\n"
+                                                                            ") => false");
+
+        const std::string missing = (std::filesystem::temp_directory_path() / "verify-records.test.missing").string();
+        CHECK(to_string(verify_records(missing, price > 0.0)) == "verify_records(missing, price > 0.0) => verify_records(file " + missing + " not readable (No such file or directory)) => false");
+    }
+#endif
+}
@@ -0,0 +1,137 @@
+//////
+/// \file     verify-views.test.cpp
+/// \brief    Test the verify_equal() functionality.
+///
+/// \details  Views of any layout must yield the same results, whether their traversal is tiled or not.
+//////
+
+#include <verify-views.hpp> // DUT
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "pretty-file.h"
+
+#define DOCTEST_CONFIG_VOID_CAST_EXPRESSIONS
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest/doctest.h>
+
+using CppVerify::column_major;
+using CppVerify::row_major;
+
+TEST_SUITE(__PRETTY_FILE__)
+{
+    TEST_CASE("verify_equal() on views of any layout")
+    {
+        // Large enough for several tiles, and no multiple of their size.
+        constexpr std::size_t I = 3, J = 70, K = 130;
+        std::vector<int> a(I * J * K), b(I * J * K);
+        const auto left = row_major(a.data(), I, J, K);
+        const auto right = column_major(b.data(), I, J, K);
+        for(std::size_t i = 0; i < I; ++i)
+            for(std::size_t j = 0; j < J; ++j)
+                for(std::size_t k = 0; k < K; ++k)
+                    left[{i, j, k}] = right[{i, j, k}] = static_cast<int>(i * J * K + j * K + k);
+
+        CHECK(verify_equal(left, right));
+        CHECK(verify_equal(right, left));
+        CHECK(verify_equal(left, left));
+        CHECK(verify_equal(right, right));
+
+        for(const std::array<std::size_t, 3> at : {std::array<std::size_t, 3>{0, 0, 0}, {2, 69, 129}, {1, 64, 63}, {0, 33, 128}})
+        {
+            right[at] = -1;
+            const auto result = verify_equal(left, right);
+            const auto transposed = verify_equal(right, left);
+            CHECK_FALSE(result);
+            CHECK_FALSE(transposed);
+#if CPP_VERIFY_DECOMPOSE
+            CHECK(result.expression.scan.first == at);
+            CHECK(result.expression.scan.mismatches == 1u);
+            CHECK(transposed.expression.scan.first == at);
+#endif
+            right[at] = left[at];
+        }
+
+        // "First" in the memory order of the left-hand side.
+        right[{0, 1, 0}] = -1;
+        right[{0, 0, 1}] = -1;
+        const auto by_rows = verify_equal(left, right);
+        const auto by_columns = verify_equal(right, left);
+        CHECK_FALSE(by_rows);
+#if CPP_VERIFY_DECOMPOSE
+        CHECK(by_rows.expression.scan.first == std::array<std::size_t, 3>{0, 0, 1});
+        CHECK(by_columns.expression.scan.first == std::array<std::size_t, 3>{0, 1, 0});
+        CHECK(by_columns.expression.scan.mismatches == 2u);
+#endif
+    }
+
+    TEST_CASE("verify_equal() on strided views")
+    {
+        // Every other element of one row, against a plain array.
+        const int interleaved[] = {1, 0, 2, 0, 3, 0, 4, 0};
+        const int plain[] = {1, 2, 3, 4};
+        const CppVerify::View<const int, 1> odd{interleaved, {4}, {2}};
+        const CppVerify::View<const int, 1> reversed{plain + 3, {4}, {-1}};
+
+        CHECK(verify_equal(odd, row_major(plain, 4)));
+        CHECK_FALSE(verify_equal(odd, reversed));
+        CHECK_FALSE(verify_equal(row_major(plain, 4), row_major(plain, 3)));
+    }
+
+    TEST_CASE("verify_equal() within a tolerance")
+    {
+        const double measured[] = {1.0, 2.05, 2.95, 4.0};
+        const double expected[] = {1.0, 2.0, 3.0, 4.0};
+        const std::uint8_t dark[] = {10, 20};
+        const std::uint8_t bright[] = {12, 18};
+
+        CHECK_FALSE(verify_equal(row_major(measured, 2, 2), row_major(expected, 2, 2)));
+        CHECK(verify_equal(row_major(measured, 2, 2), row_major(expected, 2, 2), 0.1));
+        CHECK_FALSE(verify_equal(row_major(measured, 2, 2), row_major(expected, 2, 2), 0.01));
+        CHECK(verify_equal(row_major(dark, 2), row_major(bright, 2), 2));
+        CHECK_FALSE(verify_equal(row_major(dark, 2), row_major(bright, 2), 1));
+
+        const double nan[] = {std::numeric_limits<double>::quiet_NaN()};
+        CHECK_FALSE(verify_equal(row_major(nan, 1), row_major(nan, 1), 1.0));
+    }
+
+#if CPP_VERIFY_DECOMPOSE
+    TEST_CASE("verify_equal() printing")
+    {
+        float pixels[3 * 4];
+        float expected[3 * 4];
+        for(int i = 0; i < 12; ++i)
+            pixels[i] = expected[i] = static_cast<float>(i + 1);
+        pixels[6] = 5;
+        expected[6] = 7;
+        const int line[] = {1, 2, 3};
+        const int other[] = {1, 2, 4};
+
+        std::stringstream os;
+        os << verify_equal(row_major(pixels, 3, 4), row_major(expected, 3, 4)) << '\n'
+           << verify_equal(row_major(pixels, 4, 3), row_major(expected, 4, 3), 3) << '\n'
+           << !verify_equal(row_major(line, 3), row_major(other, 3)) << '\n'
+           << verify_equal(row_major(line, 3), row_major(other, 2)) << '\n'
+           << verify_equal(row_major(line, 1, 3), column_major(line, 1, 3));
+        CHECK(os.str() == "verify_equal(row_major(pixels, 3, 4), row_major(expected, 3, 4)) => verify_equal((1, 2): 5 vs. 7; 1 of 12 elements differ\n"
+                          "      [1] [2] [3]\n"
+                          "  [0]   2   3   4\n"
+                          "  [1]   6 5/7   8\n"
+                          "  [2]  10  11  12\n"
+                          ") => false\n"
+                          "verify_equal(row_major(pixels, 4, 3), row_major(expected, 4, 3), 3) => verify_equal(12 elements equal within 3) => true\n"
+                          "!verify_equal(row_major(line, 3), row_major(other, 3)) => !verify_equal((2): 3 vs. 4; 1 of 3 elements differ\n"
+                          "   [1] [2]\n"
+                          "     2 3/4\n"
+                          ") => true\n"
+                          "verify_equal(row_major(line, 3), row_major(other, 2)) => verify_equal(extents differ: (3) != (2)) => false\n"
+                          "verify_equal(row_major(line, 1, 3), column_major(line, 1, 3)) => verify_equal(3 elements equal) => true");
+    }
+#endif
+}
@@ -24,9 +24,26 @@
 
 #include <verify.hpp> // DUT
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <exception>
 #include <iostream>
+#include <limits>
+#include <list>
+#include <map>
+#include <random>
+#include <set>
 #include <sstream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "pretty-file.h"
 
@@ -46,7 +63,7 @@ TEST_SUITE(__PRETTY_FILE__)
 
     TEST_CASE("verify() double negation")
     {
-        int x;
+        int x = 0;
         auto t = verify(x);
         auto f = !t;
 
@@ -91,8 +108,111 @@ TEST_SUITE(__PRETTY_FILE__)
 
         CHECK(verify(a != b));
         CHECK_FALSE(verify(a == b));
+    }
+
+#if CPP_VERIFY_DECOMPOSE && CPP_VERIFY__THREE_WAY
+    int spaceship_calls = 0;
+    int less_calls = 0;
+
+    struct Key
+    {
+        int value;
+
+        friend std::strong_ordering operator<=>(const Key & k1, const Key & k2) { ++spaceship_calls; return (k1.value <=> k2.value); }
+        friend bool operator<(const Key & k1, const Key & k2) { ++less_calls; return (k1.value < k2.value); }
+        friend bool operator==(const Key & k1, const Key & k2) { return (k1.value == k2.value); }
+        friend std::ostream & operator<<(std::ostream & os, const Key & k) { return os << "Key{" << k.value << '}'; }
+    };
+
+    TEST_CASE("verify() three-way comparison")
+    {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+
+        CHECK(verify(a <=> b));
+        CHECK_FALSE(verify(1.0 <=> nan));
+        CHECK(verify((a <=> b) < 0));
+        CHECK(verify((a <=> b) != 0));
+        CHECK_FALSE(verify((a <=> b) == 0));
 
-        //TODO: operator<=>
+        // Relational comparisons call the operator the language calls, once: the own operator<, or else <=>.
+        spaceship_calls = 0;
+        less_calls = 0;
+        const auto pass = verify(Key{1} < Key{2});
+        CHECK(pass);
+        CHECK(less_calls == 1);
+        CHECK(spaceship_calls == 0);
+        CHECK(verify(Key{1} <= Key{2}));
+        CHECK(less_calls == 1);
+        CHECK(spaceship_calls == 1);
+
+        std::stringstream os;
+        os << pass << '\n' << verify(Key{1} <=> Key{2}) << '\n' << verify(1.0 <=> nan) << '\n' << verify((a <=> b) == 0);
+        CHECK(less_calls == 1);
+        CHECK(spaceship_calls == 2);
+        CHECK(os.str() == "verify(Key{1} < Key{2}) => verify(Key{1} < Key{2}) => true\n"
+                          "verify(Key{1} <=> Key{2}) => verify((Key{1} <=> Key{2}) == std::strong_ordering::less) => true\n"
+                          "verify(1.0 <=> nan) => verify((1 <=> nan) == std::partial_ordering::unordered) => false\n"
+                          "verify((a <=> b) == 0) => verify(std::strong_ordering::less == 0) => false");
+    }
+#endif
+
+    TEST_CASE("verify() printing")
+    {
+        std::stringstream os;
+        os << verify(a < b) << '\n' << !verify(a > b);
+
+#if CPP_VERIFY_DECOMPOSE
+        CHECK(os.str() == "verify(a < b) => verify(1 < 2) => true\n!verify(a > b) => !verify(1 > 2) => true");
+#else
+        CHECK(os.str() == "verify(a < b) => true\n!verify(a > b) => true");
+#endif
+    }
+
+    TEST_CASE("verify() floating-point tolerance")
+    {
+        using CppVerify::within_abs;
+        using CppVerify::within_rel;
+        using CppVerify::within_ulps;
+
+        const double x = 0.1 + 0.2;
+        const double inf = std::numeric_limits<double>::infinity();
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+
+        CHECK_FALSE(verify(x == 0.3));
+        CHECK(verify(x == within_abs(0.3, 1e-15)));
+        CHECK_FALSE(verify(x == within_abs(0.3, 1e-17)));
+        CHECK(verify(x == within_rel(0.3, 1e-15)));
+        CHECK(verify(x == within_ulps(0.3, 1)));
+        CHECK_FALSE(verify(x == within_ulps(0.3, 0)));
+
+        CHECK(verify(-0.0 == within_ulps(0.0, 0)));
+        CHECK(verify(1.0f == within_ulps(std::nextafter(1.0f, 2.0f), 1)));
+        CHECK(verify(-1.0 == within_ulps(std::nextafter(-1.0, 0.0), 1)));
+        CHECK(verify(inf == within_abs(inf, 0.0)));
+        CHECK(verify(inf == within_rel(inf, 0.0)));
+        CHECK_FALSE(verify(nan == within_abs(nan, inf)));
+        CHECK_FALSE(verify(nan == within_ulps(nan, ~0ull)));
+
+        static_assert(CppVerify::ABS_EQ::evaluate(1.0, within_abs(1.5, 0.5)));
+        static_assert(!CppVerify::REL_EQ::evaluate(1.0, within_rel(2.0, 0.25)));
+        static_assert(CppVerify::REL_EQ::difference(0.0, within_rel(0.0, 0.25)) == 0.0);
+
+#if CPP_VERIFY_DECOMPOSE
+        std::stringstream os;
+        os << verify(x == within_abs(0.3, 1e-17)) << '\n' << verify(1.0 == within_rel(0.5, 0.5)) << '\n' << verify(x == within_ulps(0.3, 1));
+        CHECK(os.str() == "verify(x == within_abs(0.3, 1e-17)) => verify(0.30000000000000004 == 0.29999999999999999 (absolute difference 5.5511151231257827e-17 > 1.0000000000000001e-17)) => false\n"
+                          "verify(1.0 == within_rel(0.5, 0.5)) => verify(1 == 0.5 (relative difference 0.5 <= 0.5)) => true\n"
+                          "verify(x == within_ulps(0.3, 1)) => verify(0.30000000000000004 == 0.29999999999999999 (difference in ulps 1 <= 1)) => true");
+
+        // Equal values are within any tolerance, even where their difference wouldn't be a number.
+        os.str("");
+        os << verify(inf == within_abs(inf, 0.0)) << '\n' << verify(0.0 == within_rel(0.0, 0.5)) << '\n' << verify(nan == within_abs(nan, inf)) << '\n'
+           << verify(x != within_abs(0.3, 0.5));
+        CHECK(os.str() == "verify(inf == within_abs(inf, 0.0)) => verify(inf == inf (absolute difference 0 <= 0)) => true\n"
+                          "verify(0.0 == within_rel(0.0, 0.5)) => verify(0 == 0 (relative difference 0 <= 0.5)) => true\n"
+                          "verify(nan == within_abs(nan, inf)) => verify(nan == nan (absolute difference nan > inf)) => false\n"
+                          "verify(x != within_abs(0.3, 0.5)) => verify(0.30000000000000004 != 0.29999999999999999 (absolute difference 5.5511151231257827e-17 <= 0.5)) => false");
+#endif
     }
 
     TEST_CASE("verify() with if()")
@@ -174,4 +294,498 @@ TEST_SUITE(__PRETTY_FILE__)
         CHECK(foo_calls == 2);
         CHECK(bar_calls == 2);
     }
+
+    TEST_CASE("verify() aggregation via && and ||")
+    {
+        foo_calls = 0;
+        bar_calls = 0;
+
+        // The right-hand side is evaluated only when necessary.
+        auto pass = verify(a < b) && verify_lazily(foo() < bar());
+        CHECK(pass);
+        CHECK(foo_calls == 1);
+        CHECK(pass.rhs.has_value());
+
+        auto fail = verify(a > b) && verify_lazily(foo() < bar());
+        CHECK_FALSE(fail);
+        CHECK(foo_calls == 1);
+        CHECK_FALSE(fail.rhs.has_value());
+
+        // (Extra parentheses keep doctest from decomposing the expression itself.)
+        CHECK((verify(a < b) || verify_lazily(foo() < bar())));
+        CHECK(foo_calls == 1);
+        CHECK((verify(a > b) || verify_lazily(foo() < bar())));
+        CHECK(foo_calls == 2);
+
+        // Chaining and negation.
+        CHECK((verify(a < b) && verify_lazily(a != b) && verify_lazily(b > a)));
+        CHECK_FALSE((verify(a < b) && verify_lazily(a != b) && verify_lazily(b < a)));
+        CHECK((!verify(a > b) && verify_lazily(a != b)));
+        CHECK(!(verify(a > b) || verify_lazily(b < a)));
+        CHECK(!!(verify(a < b) || verify_lazily(b < a)));
+
+        static_assert(std::is_same_v<decltype(pass), decltype(!!pass)>);
+        static_assert(std::is_same_v<decltype(!pass), decltype(!!!pass)>);
+
+        std::stringstream os;
+        os << fail << '\n' << !pass;
+#if CPP_VERIFY_DECOMPOSE
+        CHECK(os.str() == "(verify(a > b) => verify(1 > 2) => false) && (verify(foo() < bar()) => not evaluated) => false\n"
+                          "!((verify(a < b) => verify(1 < 2) => true) && (verify(foo() < bar()) => verify(1 < 2) => true)) => false");
+#else
+        CHECK(os.str() == "(verify(a > b) => false) && (verify(foo() < bar()) => not evaluated) => false\n"
+                          "!((verify(a < b) => true) && (verify(foo() < bar()) => true)) => false");
+#endif
+    }
+
+#if CPP_VERIFY_DECOMPOSE
+    TEST_CASE("verify() printing of long strings")
+    {
+        std::string json;
+        for(int i = 0; i < 1000; ++i)
+            json += "{\"id\": " + std::to_string(i) + "},\n";
+        std::string other = json;
+        other[json.find("\"id\": 500")] = '\'';
+        const std::string_view view = json;
+        const char * const head = "{\"id\": 0},\n{\"id\": 1},\n{\"id\": 2},\n{\"id\": 3},\n";
+
+        CHECK_FALSE(verify(json == other));
+        CHECK(verify(view == json));
+        CHECK_FALSE(verify(head == view));
+
+        std::stringstream os;
+        os << verify(json == other) << '\n' << !verify(view != json) << '\n' << verify(head == view) << '\n' << verify(std::string("abc") != "abc");
+        CHECK(os.str() == "verify(json == other) => verify(12890 characters == 12890 characters, first difference at offset 6391 (line 501, column 2)\n"
+                          "  ...97},\\n{\"id\": 498},\\n{\"id\": 499},\\n{\"id\": 500},\\n{\"id\": 501},\\n{\"id\": ...\n"
+                          "  ...97},\\n{\"id\": 498},\\n{\"id\": 499},\\n{'id\": 500},\\n{\"id\": 501},\\n{\"id\": ...\n"
+                          "                                        ^\n"
+                          ") => false\n"
+                          "!verify(view != json) => !verify(12890 characters != 12890 characters, no difference) => true\n"
+                          "verify(head == view) => verify(44 characters == 12890 characters, first difference at offset 44 (line 5, column 1)\n"
+                          "  ...\"id\": 1},\\n{\"id\": 2},\\n{\"id\": 3},\\n\n"
+                          "  ...\"id\": 1},\\n{\"id\": 2},\\n{\"id\": 3},\\n{\"id\": 4},\\n{\"id\": 5},\\n{\"id\": 6},...\n"
+                          "                                        ^\n"
+                          ") => false\n"
+                          "verify(std::string(\"abc\") != \"abc\") => verify(abc != abc) => false");
+    }
+
+    TEST_CASE("verify() diff of ranges")
+    {
+        // The edit script must turn one sequence into the other, in as few edits as the longest common subsequence allows.
+        std::mt19937 random(42);
+        for(int round = 0; round < 200; ++round)
+        {
+            std::vector<int> a(random() % 12), b(random() % 12);
+            for(int & x : a) x = static_cast<int>(random() % 3);
+            for(int & x : b) x = static_cast<int>(random() % 3);
+
+            std::vector<std::vector<std::size_t>> lcs(a.size() + 1, std::vector<std::size_t>(b.size() + 1, 0));
+            for(std::size_t i = 1; i <= a.size(); ++i)
+                for(std::size_t j = 1; j <= b.size(); ++j)
+                    lcs[i][j] = (a[i - 1] == b[j - 1]) ? lcs[i - 1][j - 1] + 1 : std::max(lcs[i - 1][j], lcs[i][j - 1]);
+
+            std::vector<CppVerify::Edit> edits;
+            REQUIRE(CppVerify::myers_diff(a.begin(), a.size(), b.begin(), b.size(), edits, 24));
+            CHECK(edits.size() == a.size() + b.size() - 2 * lcs[a.size()][b.size()]);
+
+            std::vector<int> patched;
+            std::size_t i = 0;
+            std::size_t j = 0;
+            for(const auto & edit : edits)
+            {
+                for(; edit.insertion ? (j < edit.index) : (i < edit.index); ++i, ++j)
+                    patched.push_back(a[i]);
+                if(edit.insertion)
+                    patched.push_back(b[j++]);
+                else
+                    ++i;
+            }
+            patched.insert(patched.end(), a.begin() + static_cast<std::ptrdiff_t>(i), a.end());
+            CHECK(patched == b);
+        }
+
+        // Beyond either limit, there is no edit script.
+        const std::vector<int> x = {1, 2, 3, 4, 5, 6};
+        const std::vector<int> y = {6, 5, 4, 3, 2, 1};
+        std::vector<CppVerify::Edit> edits;
+        CHECK(CppVerify::myers_diff(x.begin(), x.size(), y.begin(), y.size(), edits, 10));
+        CHECK_FALSE(CppVerify::myers_diff(x.begin(), x.size(), y.begin(), y.size(), edits, 9));
+        CHECK_FALSE(CppVerify::myers_diff(x.begin(), x.size(), x.rbegin(), x.size(), edits, 10, 0));
+    }
+
+    TEST_CASE("verify() printing of ranges")
+    {
+        std::vector<int> a(1000);
+        for(std::size_t i = 0; i < a.size(); ++i)
+            a[i] = static_cast<int>(i);
+        std::vector<int> b = a;
+        b[17] = -5;
+        b.insert(b.begin() + 500, 42);
+        std::vector<int> reversed(a.rbegin(), a.rend());
+        const std::list<int> list(a.begin(), a.end());
+        const std::vector<int> few = {1, 2, 3};
+        const std::vector<std::vector<int>> nested = {{1, 2}, {}};
+
+        std::stringstream os;
+        os << verify(a == b) << '\n' << !verify(a != a) << '\n' << verify(a == reversed) << '\n' << verify(list == list) << '\n'
+           << verify(few == nested[0]) << '\n' << verify(nested != nested) << '\n' << verify(a < few);
+        CHECK(os.str() == "verify(a == b) => verify(1000 elements == 1001 elements, 3 edits:\n"
+                          "  - [17]: 17\n"
+                          "  + [17]: -5\n"
+                          "  + [500]: 42\n"
+                          ") => false\n"
+                          "!verify(a != a) => !verify(1000 elements != 1000 elements, no difference) => true\n"
+                          "verify(a == reversed) => verify(1000 elements == 1000 elements, too many edits to list, first difference at [0]: 0 vs. 999) => false\n"
+                          "verify(list == list) => verify(1000 elements == 1000 elements, no difference) => true\n"
+                          "verify(few == nested[0]) => verify({1, 2, 3} == {1, 2}) => false\n"
+                          "verify(nested != nested) => verify({{1, 2}, {}} != {{1, 2}, {}}) => false\n"
+                          "verify(a < few) => verify({0, 1, 2, 3, 4, 5, 6, 7, ...} (1000 elements) < {1, 2, 3}) => true");
+    }
+
+    TEST_CASE("verify() printing of arrays")
+    {
+        // The iterators of std::array may be plain pointers.
+        const std::array<int, 10> a = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        std::array<int, 10> b = a;
+        b[3] = -1;
+        const std::array<int, 10> same = a;
+
+        std::stringstream os;
+        os << verify(a == b) << '\n' << verify(same != a);
+        CHECK(os.str() == "verify(a == b) => verify(10 elements == 10 elements, 2 edits:\n"
+                          "  - [3]: 3\n"
+                          "  + [3]: -1\n"
+                          ") => false\n"
+                          "verify(same != a) => verify(10 elements != 10 elements, no difference) => false");
+    }
+
+    TEST_CASE("verify() printing of sets and maps")
+    {
+        std::unordered_map<int, std::string> routes;
+        for(int i = 0; i < 100000; ++i)
+            routes[i] = "eth" + std::to_string(i % 4);
+        std::unordered_map<int, std::string> changed = routes;
+        changed.erase(7);
+        changed[42] = "lo";
+        std::unordered_map<int, std::string> added = routes;
+        added[100000] = "eth9";
+
+        std::map<int, int> squares;
+        for(int i = 0; i < 100; ++i)
+            squares[i] = i * i;
+        std::map<int, int> wrong = squares;
+        for(int i = 0; i < 20; ++i)
+            wrong[i] = -1;
+
+        std::unordered_set<int> keys;
+        for(int i = 0; i < 100; ++i)
+            keys.insert(i);
+        const std::set<int> more = {1, 2};
+
+        CHECK_FALSE(verify(routes == changed));
+        CHECK(verify(squares == squares));
+
+        std::stringstream os;
+        os << verify(routes == added) << '\n' << !verify(routes != routes) << '\n' << verify(squares == wrong) << '\n'
+           << verify(std::set<int>{3} == more) << '\n';
+        os << verify(keys == std::unordered_set<int>(keys.begin(), keys.end()));
+        CHECK(os.str() == "verify(routes == added) => verify(100000 elements == 100001 elements, 0 only left, 1 only right, 0 changed:\n"
+                          "  + [100000]: eth9\n"
+                          ") => false\n"
+                          "!verify(routes != routes) => !verify(100000 elements != 100000 elements, no difference) => true\n"
+                          "verify(squares == wrong) => verify(100 elements == 100 elements, 0 only left, 0 only right, 20 changed:\n"
+                          "  ~ [0]: 0 vs. -1\n  ~ [1]: 1 vs. -1\n  ~ [2]: 4 vs. -1\n  ~ [3]: 9 vs. -1\n"
+                          "  ~ [4]: 16 vs. -1\n  ~ [5]: 25 vs. -1\n  ~ [6]: 36 vs. -1\n  ~ [7]: 49 vs. -1\n"
+                          "  ~ [8]: 64 vs. -1\n  ~ [9]: 81 vs. -1\n  ~ [10]: 100 vs. -1\n  ~ [11]: 121 vs. -1\n"
+                          "  ~ [12]: 144 vs. -1\n  ~ [13]: 169 vs. -1\n  ~ [14]: 196 vs. -1\n  ~ [15]: 225 vs. -1\n"
+                          "  ... (4 more)\n"
+                          ") => false\n"
+                          "verify(std::set<int>{3} == more) => verify({3} == {1, 2}) => false\n"
+                          "verify(keys == std::unordered_set<int>(keys.begin(), keys.end())) => verify(100 elements == 100 elements, no difference) => true");
+
+        std::stringstream changes;
+        changes << verify(routes == changed);
+        CHECK(changes.str().find("1 only left, 0 only right, 1 changed:\n") != std::string::npos);
+        CHECK(changes.str().find("  - [7]: eth3\n") != std::string::npos);
+        CHECK(changes.str().find("  ~ [42]: eth2 vs. lo\n") != std::string::npos);
+    }
+
+    struct Endpoint
+    {
+        std::string host;
+        int port;
+
+        bool operator==(const Endpoint & other) const { return (host == other.host && port == other.port); }
+    };
+
+    struct Limits
+    {
+        char level;     // Followed by padding, i.e. no memcmp() shortcut.
+        int soft;
+        int hard;
+
+        bool operator==(const Limits & other) const { return (level == other.level && soft == other.soft && hard == other.hard); }
+        bool operator<(const Limits & other) const { return (soft < other.soft); }
+    };
+
+    struct Counters
+    {
+        int c0, c1, c2, c3, c4, c5, c6, c7, c8, c9, c10, c11, c12, c13, c14, c15, c16, c17, c18, c19;
+
+        bool operator==(const Counters & other) const { return (std::memcmp(this, &other, sizeof(Counters)) == 0); }
+    };
+
+    struct Empty
+    {
+        bool operator==(const Empty &) const { return true; }
+    };
+
+    TEST_CASE("verify() printing of aggregates")
+    {
+        static_assert(CppVerify::field_count<Endpoint>() == 2);
+        static_assert(CppVerify::field_count<Counters>() == 20);
+        static_assert(CppVerify::field_count<Empty>() == 0);
+        static_assert(CppVerify::is_aggregate<Limits>::value);
+        static_assert(!CppVerify::is_aggregate<std::array<int, 3>>::value);
+        static_assert(!CppVerify::is_aggregate<int[3]>::value);
+
+        const Endpoint local{"localhost", 8080};
+        const Endpoint remote{"example.org", 8080};
+        const Limits low{'w', 10, 20};
+        const Limits high{'w', 10, 30};
+        Counters counters{};
+        Counters reset{};
+        for(int * c = &counters.c2; c <= &counters.c19; ++c)
+            *c = 1;
+
+        CHECK_FALSE(verify(local == remote));
+        CHECK(verify(low == low));
+
+        std::stringstream os;
+        os << verify(local == remote) << '\n' << verify(low == high) << '\n' << !verify(low == low) << '\n'
+           << verify(high < low) << '\n' << verify(reset == Counters{}) << '\n' << verify(Empty{} == Empty{}) << '\n'
+           << verify(counters == reset);
+        CHECK(os.str() == "verify(local == remote) => verify(2 fields == 2 fields, 1 differs:\n"
+                          "  [0]: localhost vs. example.org\n"
+                          ") => false\n"
+                          "verify(low == high) => verify(3 fields == 3 fields, 1 differs:\n"
+                          "  [2]: 20 vs. 30\n"
+                          ") => false\n"
+                          "!verify(low == low) => !verify(3 fields == 3 fields, no difference) => false\n"
+                          "verify(high < low) => verify({w, 10, 30} < {w, 10, 20}) => false\n"
+                          "verify(reset == Counters{}) => verify(20 fields == 20 fields, no difference) => true\n"
+                          "verify(Empty{} == Empty{}) => verify(0 fields == 0 fields, no difference) => true\n"
+                          "verify(counters == reset) => verify(20 fields == 20 fields, 18 differ:\n"
+                          "  [2]: 1 vs. 0\n  [3]: 1 vs. 0\n  [4]: 1 vs. 0\n  [5]: 1 vs. 0\n"
+                          "  [6]: 1 vs. 0\n  [7]: 1 vs. 0\n  [8]: 1 vs. 0\n  [9]: 1 vs. 0\n"
+                          "  [10]: 1 vs. 0\n  [11]: 1 vs. 0\n  [12]: 1 vs. 0\n  [13]: 1 vs. 0\n"
+                          "  [14]: 1 vs. 0\n  [15]: 1 vs. 0\n  [16]: 1 vs. 0\n  [17]: 1 vs. 0\n"
+                          "  ... (2 more)\n"
+                          ") => false");
+    }
+
+    enum class Permission : unsigned char { read = 1, write = 2, exec = 4 };
+
+    TEST_CASE("verify() printing of bit flags")
+    {
+        using CppVerify::bits;
+        constexpr const char * names[] = {"READ", "WRITE", "EXEC"};
+        const unsigned flags = 0xc;
+        const unsigned expected = 0x5;
+        const std::uint64_t all = ~std::uint64_t(0);
+
+        CHECK(verify(flags == bits(0xcu)));
+        CHECK_FALSE(verify(flags == bits(expected, names)));
+        CHECK(verify(Permission::exec == bits(Permission::exec)));
+
+        std::stringstream os;
+        os << verify(flags == bits(expected, names)) << '\n' << !verify(flags != bits(expected)) << '\n'
+           << verify(Permission::read == bits(Permission::exec, names)) << '\n' << verify(flags == bits(flags)) << '\n'
+           << verify(all == bits(std::uint64_t(1)));
+        CHECK(os.str() == "verify(flags == bits(expected, names)) => verify(0x0000000c == 0x00000005 (2 bits differ: [0] READ: 0 vs. 1, [3]: 1 vs. 0)) => false\n"
+                          "!verify(flags != bits(expected)) => !verify(0x0000000c != 0x00000005 (2 bits differ: [0]: 0 vs. 1, [3]: 1 vs. 0)) => false\n"
+                          "verify(Permission::read == bits(Permission::exec, names)) => verify(0x01 == 0x04 (2 bits differ: [0] READ: 1 vs. 0, [2] EXEC: 0 vs. 1)) => false\n"
+                          "verify(flags == bits(flags)) => verify(0x0000000c == 0x0000000c (no difference)) => true\n"
+                          "verify(all == bits(std::uint64_t(1))) => verify(0xffffffffffffffff == 0x0000000000000001 (63 bits differ: "
+                          "[1]: 1 vs. 0, [2]: 1 vs. 0, [3]: 1 vs. 0, [4]: 1 vs. 0, [5]: 1 vs. 0, [6]: 1 vs. 0, [7]: 1 vs. 0, [8]: 1 vs. 0, "
+                          "[9]: 1 vs. 0, [10]: 1 vs. 0, [11]: 1 vs. 0, [12]: 1 vs. 0, [13]: 1 vs. 0, [14]: 1 vs. 0, [15]: 1 vs. 0, [16]: 1 vs. 0, "
+                          "... (47 more))) => false");
+    }
+
+    TEST_CASE("verify() printing of bitsets")
+    {
+        const std::bitset<8> low("00001100");
+        const std::bitset<8> high("00000101");
+        std::bitset<4096> wide;
+        std::bitset<4096> other;
+        wide[17] = true;
+        other[4000] = true;
+        other[4095] = true;
+
+        // Partial words at the end, and the words of either side in different states.
+        std::vector<bool> set(1000);
+        std::vector<bool> unset(1000);
+        set[3] = true;
+        unset[64] = true;
+        unset[999] = true;
+        std::vector<bool> longer = set;
+        longer.push_back(true);
+        const std::vector<bool> ten = {true, false};
+        const std::vector<bool> eleven = {true, true};
+
+        std::stringstream os;
+        os << verify(low == high) << '\n' << verify(wide == other) << '\n' << verify(wide == wide) << '\n'
+           << verify(set == unset) << '\n' << verify(set == longer) << '\n' << verify(ten == eleven);
+        CHECK(os.str() == "verify(low == high) => verify(00001100 == 00000101 (2 bits differ: [0]: 0 vs. 1, [3]: 1 vs. 0)) => false\n"
+                          "verify(wide == other) => verify(4096 bits == 4096 bits, 3 bits differ:\n"
+                          "  [17]: 1 vs. 0\n"
+                          "  [4000]: 0 vs. 1\n"
+                          "  [4095]: 0 vs. 1\n"
+                          ") => false\n"
+                          "verify(wide == wide) => verify(4096 bits == 4096 bits, no difference) => true\n"
+                          "verify(set == unset) => verify(1000 bits == 1000 bits, 3 bits differ:\n"
+                          "  [3]: 1 vs. 0\n"
+                          "  [64]: 0 vs. 1\n"
+                          "  [999]: 0 vs. 1\n"
+                          ") => false\n"
+                          "verify(set == longer) => verify(1000 bits == 1001 bits, no difference) => false\n"
+                          "verify(ten == eleven) => verify({1, 0} == {1, 1}) => false");
+
+        // Every position, against a bit-by-bit count.
+        std::mt19937 random(42);
+        std::vector<bool> x(777);
+        for(std::size_t i = 0; i < x.size(); ++i)
+            x[i] = (random() % 2 == 0);
+        std::vector<bool> y = x;
+        for(std::size_t i = 0; i < y.size(); i += 1 + random() % 50)
+            y[i] = !y[i];
+        std::size_t differ = 0;
+        for(std::size_t i = 0; i < x.size(); ++i)
+            differ += (x[i] != y[i]);
+        std::stringstream diff;
+        diff << verify(x == y);
+        CHECK(diff.str().find("777 bits == 777 bits, " + std::to_string(differ) + " bits differ:\n") != std::string::npos);
+    }
+
+    TEST_CASE("verify() of atomic and volatile operands")
+    {
+        using namespace CppVerify;
+
+        std::atomic<int> counter{5};
+        std::atomic<bool> ready{false};
+        std::atomic<double> load{0.25};
+        volatile unsigned status = 3;
+
+        // The operands are read once, and the stored result keeps what was compared.
+        static_assert(std::is_same_v<decltype(verify(counter < 3).expression), const BinaryExpression<int, LT, int>>);
+        static_assert(std::is_same_v<decltype(verify(ready).expression), const UnaryExpression<bool>>);
+        auto fail = verify(counter < 3);
+        const auto flag = verify(ready);
+        const auto close = verify(load == within_abs(0.3, 0.1));
+        const auto bits = verify(status == 2u);
+        counter = 1;
+        ready = true;
+        load = 1.0;
+        status = 2;
+
+        std::stringstream os;
+        os << fail << '\n' << flag << '\n' << close << '\n' << bits << '\n' << verify(counter < 3);
+        CHECK(os.str() == "verify(counter < 3) => verify(5 < 3) => false\n"
+                          "verify(ready) => verify(0) => false\n"
+                          "verify(load == within_abs(0.3, 0.1)) => verify(0.25 == 0.29999999999999999 (absolute difference 0.049999999999999989 <= 0.10000000000000001)) => true\n"
+                          "verify(status == 2u) => verify(3 == 2) => false\n"
+                          "verify(counter < 3) => verify(1 < 3) => true");
+    }
+
+    TEST_CASE("verify() operand capture")
+    {
+        using namespace CppVerify;
+
+        // Small trivially copyable operands are captured by value ...
+        static_assert(!std::is_reference_v<decltype(BinaryExpression<int, LT, int>::operand1)>);
+        static_assert(!std::is_reference_v<decltype(BinaryExpression<double, LT, const char *>::operand2)>);
+        static_assert(!std::is_reference_v<decltype(UnaryExpression<volatile bool>::operand)>);
+        // ... everything else by reference.
+        static_assert(std::is_reference_v<decltype(BinaryExpression<std::string, EQ, std::string>::operand1)>);
+        static_assert(std::is_reference_v<decltype(UnaryExpression<char[4]>::operand)>);
+
+        // Size budgets.
+        static_assert(sizeof(UnaryExpression<int>) == sizeof(int));
+        static_assert(sizeof(BinaryExpression<int, LT, int>) == 2 * sizeof(int));
+        static_assert(sizeof(Decomposition<UnaryExpression<int>>) <= 2 * sizeof(void *));
+        static_assert(sizeof(Decomposition<BinaryExpression<int, LT, int>>) <= 2 * sizeof(void *));
+        static_assert(sizeof(Decomposition<BinaryExpression<double, LT, double>>) <= 4 * sizeof(void *));
+
+        // The stored result does not refer to the (dead) temporaries.
+        auto fail = !verify(foo() > bar());
+        std::stringstream os;
+        os << fail;
+        CHECK(os.str() == "!verify(foo() > bar()) => !verify(1 > 2) => true");
+    }
+
+    int payload_copies = 0;
+
+    struct Payload
+    {
+        std::string text;
+
+        explicit Payload(const char * s) : text(s) { }
+        Payload(const Payload & other) : text(other.text) { ++payload_copies; }
+        Payload(Payload &&) = default;
+
+        explicit operator bool() const { return !text.empty(); }
+        bool operator==(const Payload & other) const { return (text == other.text); }
+        friend std::ostream & operator<<(std::ostream & os, const Payload & p) { return os << '"' << p.text << '"'; }
+    };
+
+    Payload make_payload(const char * s) { return Payload(s); }
+
+    auto check_payload(const Payload & expected) { return !verify_owned(make_payload("actual") == expected); }
+
+    TEST_CASE("verify_owned() of temporaries")
+    {
+        using namespace CppVerify;
+
+        const Payload expected("expected");
+        std::string name = "name";
+
+        // Rvalues are owned, lvalues referred to, and small operands captured by value as ever.
+        static_assert(std::is_same_v<decltype(verify_owned(make_payload("a") == expected).expression), BinaryExpression<Owned<Payload>, EQ, Payload>>);
+        static_assert(std::is_same_v<decltype(verify_owned(expected == make_payload("a")).expression), BinaryExpression<Payload, EQ, Owned<Payload>>>);
+        static_assert(std::is_same_v<decltype(verify_owned(foo() < bar()).expression), const BinaryExpression<int, LT, int>>);
+        static_assert(std::is_same_v<decltype(verify_owned(name == std::string("name")).expression), BinaryExpression<std::string, EQ, Owned<std::string>>>);
+        static_assert(!std::is_reference_v<decltype(BinaryExpression<Owned<Payload>, EQ, Payload>::operand1)>);
+        static_assert(std::is_reference_v<decltype(BinaryExpression<Owned<Payload>, EQ, Payload>::operand2)>);
+        // Only verify_owned() takes ownership.
+        static_assert(std::is_same_v<decltype(verify(make_payload("a") == expected).expression), const BinaryExpression<Payload, EQ, Payload>>);
+
+        // The results outlive the temporaries, even when returned and stored, and none of the operands is copied.
+        payload_copies = 0;
+        auto fail = check_payload(expected);
+        std::vector<decltype(verify_owned(make_payload("") == expected))> results;
+        results.push_back(verify_owned(make_payload("first") == expected));
+        results.push_back(verify_owned(make_payload("expected") == expected));
+        results.push_back(verify_owned(make_payload("third") == expected));
+        auto single = verify_owned(make_payload("single"));
+        auto twice = !!verify_owned(make_payload("twice") == expected);
+        // So does the deferred side of an aggregation, whose temporaries die already when it is evaluated.
+        auto lazily = verify(name == "name") && verify_lazily(make_payload("deferred") == expected);
+        auto longer = verify(name == "name") && verify_lazily(std::string(20, 'b') == std::string(20, 'c'));
+        CHECK(payload_copies == 0);
+
+        std::stringstream os;
+        os << fail << '\n' << results[0] << '\n' << results[1] << '\n' << single << '\n' << twice << '\n'
+           << verify_owned(std::string("long enough to be allocated") == name) << '\n' << lazily << '\n' << longer;
+        CHECK(os.str() == "!verify(make_payload(\"actual\") == expected) => !verify(\"actual\" == \"expected\") => true\n"
+                          "verify(make_payload(\"first\") == expected) => verify(\"first\" == \"expected\") => false\n"
+                          "verify(make_payload(\"expected\") == expected) => verify(\"expected\" == \"expected\") => true\n"
+                          "verify(make_payload(\"single\")) => verify(\"single\") => true\n"
+                          "verify(make_payload(\"twice\") == expected) => verify(\"twice\" == \"expected\") => false\n"
+                          "verify(std::string(\"long enough to be allocated\") == name) => verify(long enough to be allocated == name) => false\n"
+                          "(verify(name == \"name\") => verify(name == name) => true) && "
+                          "(verify(make_payload(\"deferred\") == expected) => verify(\"deferred\" == \"expected\") => false) => false\n"
+                          "(verify(name == \"name\") => verify(name == name) => true) && "
+                          "(verify(std::string(20, 'b') == std::string(20, 'c')) => verify(" + std::string(20, 'b') + " == " + std::string(20, 'c') + ") => false) => false");
+    }
+#endif
 }
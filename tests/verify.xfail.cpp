@@ -42,6 +42,22 @@ using namespace CppVerify;
         auto xfail_no_complex_expressions = verify(a || b);
     }
 
+#elif XFAIL_INDEX == __COUNTER__
+
+    int main()
+    {
+        int a, b, c, d;
+        auto xfail_no_complex_expressions = verify(a < b && c != d);
+    }
+
+#elif XFAIL_INDEX == __COUNTER__
+
+    int main()
+    {
+        int a, b, c, d;
+        auto xfail_no_complex_expressions = verify(a < b || c != d);
+    }
+
 #else
 
     int main()